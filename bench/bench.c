@@ -0,0 +1,442 @@
+#define _GNU_SOURCE
+#include <inttypes.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "dyn_array.h"
+#include "processing_scheduling.h"
+
+// Scheduler and dyn_array benchmarks over generated workloads
+// HW2_bench [max_pcbs] [seed]
+// Workloads are generated from the seed, so the same arguments give the same inputs on every commit
+
+#define DEFAULT_MAX_PCBS 10000000UL
+#define DEFAULT_SEED 520UL
+// small sizes are repeated until about this many pcbs were processed so timings are stable
+#define TARGET_WORK 1000000UL
+// quadratic primitives stop at this size
+#define QUADRATIC_LIMIT 10000UL
+
+// splitmix64, small and good enough for workloads
+static uint64_t next_random(uint64_t *state)
+{
+    uint64_t z = (*state += 0x9E3779B97F4A7C15ULL);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+
+static double now_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec * 1e9 + (double)ts.tv_nsec;
+}
+
+// Bursts uniform in 1..100, priorities in 0..15, arrivals spaced so the CPU is about 90% busy
+static dyn_array_t *generate_workload(size_t count, uint64_t seed)
+{
+    dyn_array_t *pcbs = dyn_array_create(count, sizeof(ProcessControlBlock_t), NULL);
+    uint64_t state = seed;
+    uint32_t arrival = 0;
+    for (size_t i = 0; pcbs && i < count; ++i)
+    {
+        ProcessControlBlock_t pcb = {(uint32_t)(1 + next_random(&state) % 100), (uint32_t)(next_random(&state) % 16), arrival,
+                                     false};
+        dyn_array_push_back(pcbs, &pcb);
+        // mean gap of 56 against a mean burst of 50.5
+        arrival += (uint32_t)(next_random(&state) % 113);
+    }
+    return pcbs;
+}
+
+typedef struct
+{
+    const char *name;
+    int alg;
+    size_t quantum;  // or aging interval, boost interval, cores, or target latency
+} scheduler_bench_t;
+
+// MLFQ levels for the bench, each quantum 4x the last
+static const size_t mlfq_quanta[] = {4, 16, 64};
+
+static bool run_scheduler(const scheduler_bench_t *bench, dyn_array_t *queue, ScheduleResult_t *result)
+{
+    switch (bench->alg)
+    {
+    case 0:
+        return first_come_first_serve(queue, result);
+    case 1:
+        return shortest_job_first(queue, result);
+    case 2:
+        return priority(queue, result);
+    case 3:
+        return round_robin(queue, result, bench->quantum);
+    case 5:
+        return shortest_job_first_arrival_aware(queue, result);
+    case 6:
+        return priority_arrival_aware(queue, result);
+    case 7:
+        return preemptive_priority(queue, result, bench->quantum);
+    case 8:
+    {
+        MlfqConfig_t config = {sizeof(mlfq_quanta) / sizeof(mlfq_quanta[0]), mlfq_quanta, bench->quantum};
+        return multi_level_feedback_queue(queue, result, &config);
+    }
+    case 9:
+    {
+        MultiCoreConfig_t config = {bench->quantum, STEAL_MOST_LOADED, 0};
+        return multi_core_first_come_first_serve(queue, result, &config, NULL);
+    }
+    case 10:
+    {
+        CfsConfig_t config = {bench->quantum, bench->quantum / 8};
+        return completely_fair(queue, result, &config);
+    }
+    default:
+        return shortest_remaining_time_first(queue, result);
+    }
+}
+
+static bool run_soa_scheduler(const scheduler_bench_t *bench, PcbSoA_t *soa, ScheduleResult_t *result)
+{
+    switch (bench->alg)
+    {
+    case 11:
+        return first_come_first_serve_soa(soa, result);
+    case 12:
+        return shortest_job_first_soa(soa, result);
+    default:
+        return priority_soa(soa, result);
+    }
+}
+
+// ns per pcb for one scheduler on one workload, each repetition gets a fresh copy and only the call is timed
+static double time_scheduler(const scheduler_bench_t *bench, const dyn_array_t *workload)
+{
+    size_t count = dyn_array_size(workload);
+    size_t reps = count < TARGET_WORK ? TARGET_WORK / count : 1;
+    double total = 0;
+    for (size_t rep = 0; rep < reps; ++rep)
+    {
+        ScheduleResult_t result;
+        bool ok;
+        if (bench->alg >= 11)
+        {
+            // structure of arrays copies of the same workload
+            PcbSoA_t soa;
+            if (!pcb_soa_from_blocks(workload, &soa))
+            {
+                return -1;
+            }
+            double start = now_ns();
+            ok = run_soa_scheduler(bench, &soa, &result);
+            total += now_ns() - start;
+            pcb_soa_destroy(&soa);
+        }
+        else
+        {
+            dyn_array_t *queue = dyn_array_import(dyn_array_export(workload), count, sizeof(ProcessControlBlock_t), NULL);
+            double start = now_ns();
+            ok = queue && run_scheduler(bench, queue, &result);
+            total += now_ns() - start;
+            dyn_array_destroy(queue);
+        }
+        if (!ok)
+        {
+            return -1;
+        }
+    }
+    return total / ((double)reps * count);
+}
+
+typedef struct
+{
+    const char *name;
+    double (*run)(size_t count, uint64_t seed);
+    bool quadratic;
+} primitive_bench_t;
+
+// each primitive returns ns per element, -1 when an allocation failed
+
+static double bench_push_back(size_t count, uint64_t seed)
+{
+    (void)seed;
+    dyn_array_t *array = dyn_array_create(0, sizeof(ProcessControlBlock_t), NULL);
+    if (!array)
+    {
+        return -1;
+    }
+    ProcessControlBlock_t pcb = {1, 1, 1, false};
+    bool ok = true;
+    double start = now_ns();
+    for (size_t i = 0; i < count; ++i)
+    {
+        ok &= dyn_array_push_back(array, &pcb);
+    }
+    double elapsed = now_ns() - start;
+    dyn_array_destroy(array);
+    return ok ? elapsed / count : -1;
+}
+
+static double bench_fifo(dyn_array_t *array, size_t count)
+{
+    if (!array)
+    {
+        return -1;
+    }
+    ProcessControlBlock_t pcb = {1, 1, 1, false};
+    bool ok = true;
+    for (size_t i = 0; i < count; ++i)
+    {
+        ok &= dyn_array_push_back(array, &pcb);
+    }
+    double start = now_ns();
+    for (size_t i = 0; i < count; ++i)
+    {
+        dyn_array_extract_front(array, &pcb);
+        dyn_array_push_back(array, &pcb);
+    }
+    double elapsed = now_ns() - start;
+    dyn_array_destroy(array);
+    return ok ? elapsed / count : -1;
+}
+
+static double bench_fifo_plain(size_t count, uint64_t seed)
+{
+    (void)seed;
+    return bench_fifo(dyn_array_create(count, sizeof(ProcessControlBlock_t), NULL), count);
+}
+
+static double bench_fifo_ring(size_t count, uint64_t seed)
+{
+    (void)seed;
+    return bench_fifo(dyn_array_create_ring(count, sizeof(ProcessControlBlock_t), NULL), count);
+}
+
+static double bench_at(size_t count, uint64_t seed)
+{
+    dyn_array_t *array = generate_workload(count, seed);
+    if (!array)
+    {
+        return -1;
+    }
+    unsigned long sum = 0;
+    double start = now_ns();
+    for (size_t i = 0; i < count; ++i)
+    {
+        sum += ((ProcessControlBlock_t *)dyn_array_at(array, i))->remaining_burst_time;
+    }
+    double elapsed = now_ns() - start;
+    dyn_array_destroy(array);
+    // keep the loop from being thrown away
+    if (sum == 0)
+    {
+        fprintf(stderr, "empty workload\n");
+    }
+    return elapsed / count;
+}
+
+static double bench_sort(size_t count, uint64_t seed)
+{
+    dyn_array_t *array = generate_workload(count, seed);
+    if (!array)
+    {
+        return -1;
+    }
+    double start = now_ns();
+    bool ok = dyn_array_sort(array, sjf_compare);
+    double elapsed = now_ns() - start;
+    dyn_array_destroy(array);
+    return ok ? elapsed / count : -1;
+}
+
+static double bench_radix_sort(size_t count, uint64_t seed)
+{
+    dyn_array_t *array = generate_workload(count, seed);
+    if (!array)
+    {
+        return -1;
+    }
+    double start = now_ns();
+    bool ok = dyn_array_sort_by_u32_key(array, offsetof(ProcessControlBlock_t, remaining_burst_time),
+                                        offsetof(ProcessControlBlock_t, arrival));
+    double elapsed = now_ns() - start;
+    dyn_array_destroy(array);
+    return ok ? elapsed / count : -1;
+}
+
+static double bench_parallel_sort(size_t count, uint64_t seed)
+{
+    dyn_array_t *array = generate_workload(count, seed);
+    if (!array)
+    {
+        return -1;
+    }
+    double start = now_ns();
+    bool ok = dyn_array_sort_parallel(array, sjf_compare, 0, true);
+    double elapsed = now_ns() - start;
+    dyn_array_destroy(array);
+    return ok ? elapsed / count : -1;
+}
+
+static double bench_insert_sorted(size_t count, uint64_t seed)
+{
+    dyn_array_t *workload = generate_workload(count, seed);
+    dyn_array_t *array = dyn_array_create(count, sizeof(ProcessControlBlock_t), NULL);
+    if (!workload || !array)
+    {
+        dyn_array_destroy(array);
+        dyn_array_destroy(workload);
+        return -1;
+    }
+    double start = now_ns();
+    for (size_t i = 0; i < count; ++i)
+    {
+        dyn_array_insert_sorted(array, dyn_array_at(workload, i), sjf_compare);
+    }
+    double elapsed = now_ns() - start;
+    dyn_array_destroy(array);
+    dyn_array_destroy(workload);
+    return elapsed / count;
+}
+
+// arrivals come in bursts of 64 into a queue kept in arrival order
+static double bench_insert_sorted_many(size_t count, uint64_t seed)
+{
+    dyn_array_t *workload = generate_workload(count, seed);
+    dyn_array_t *array = dyn_array_create(count, sizeof(ProcessControlBlock_t), NULL);
+    if (!workload || !array)
+    {
+        dyn_array_destroy(array);
+        dyn_array_destroy(workload);
+        return -1;
+    }
+    const ProcessControlBlock_t *pcbs = dyn_array_export(workload);
+    bool ok = true;
+    double start = now_ns();
+    for (size_t i = 0; i < count; i += 64)
+    {
+        // the batch is merged through a scratch buffer, which can fail to allocate
+        ok &= dyn_array_insert_sorted_many(array, pcbs + i, count - i < 64 ? count - i : 64, arrival_time_compare);
+    }
+    double elapsed = now_ns() - start;
+    dyn_array_destroy(array);
+    dyn_array_destroy(workload);
+    return ok ? elapsed / count : -1;
+}
+
+static double bench_import(size_t count, uint64_t seed)
+{
+    dyn_array_t *workload = generate_workload(count, seed);
+    if (!workload)
+    {
+        return -1;
+    }
+    double start = now_ns();
+    dyn_array_t *copy = dyn_array_import(dyn_array_export(workload), count, sizeof(ProcessControlBlock_t), NULL);
+    double elapsed = now_ns() - start;
+    bool ok = copy != NULL;
+    dyn_array_destroy(copy);
+    dyn_array_destroy(workload);
+    return ok ? elapsed / count : -1;
+}
+
+// prints one timing and its ratio to the previous size, "-" for a failed run (which also breaks the ratio chain)
+static void print_timing(double ns, double *previous)
+{
+    if (ns < 0)
+    {
+        printf(" %16s", "-");
+        *previous = 0;
+        return;
+    }
+    printf(" %8.1f (%5.2f)", ns, *previous > 0 ? ns / *previous : 1.0);
+    *previous = ns;
+}
+
+int main(int argc, char **argv)
+{
+    size_t max_pcbs = DEFAULT_MAX_PCBS;
+    uint64_t seed = DEFAULT_SEED;
+    if ((argc > 1 && sscanf(argv[1], "%zu", &max_pcbs) != 1) || (argc > 2 && sscanf(argv[2], "%" SCNu64, &seed) != 1))
+    {
+        printf("%s [max_pcbs] [seed]\n", argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    const scheduler_bench_t schedulers[] = {
+        {"FCFS", 0, 0}, {"SJF", 1, 0}, {"P", 2, 0}, {"RR4", 3, 4}, {"RR16", 3, 16}, {"RR64", 3, 64}, {"SRTF", 4, 0},
+        {"SJF_arr", 5, 0}, {"P_arr", 6, 0}, {"PP16", 7, 16},
+        {"MLFQ3", 8, 1024}, {"FCFS_8c", 9, 8}, {"CFS24", 10, 24},
+        {"FCFS_soa", 11, 0}, {"SJF_soa", 12, 0}, {"P_soa", 13, 0},
+    };
+    const size_t scheduler_count = sizeof(schedulers) / sizeof(schedulers[0]);
+    const primitive_bench_t primitives[] = {
+        {"push_back", bench_push_back, false},
+        {"fifo", bench_fifo_plain, true},
+        {"fifo_ring", bench_fifo_ring, false},
+        {"at", bench_at, false},
+        {"sort", bench_sort, false},
+        {"radix_sort", bench_radix_sort, false},
+        {"par_sort", bench_parallel_sort, false},
+        {"ins_sorted", bench_insert_sorted, true},
+        {"ins_many", bench_insert_sorted_many, false},
+        {"import", bench_import, false},
+    };
+    const size_t primitive_count = sizeof(primitives) / sizeof(primitives[0]);
+
+    printf("seed %" PRIu64 ", ns per pcb (ns per element for dyn_array), ratio to the previous size in ()\n\n", seed);
+
+    printf("%10s", "pcbs");
+    for (size_t s = 0; s < scheduler_count; ++s)
+    {
+        printf(" %16s", schedulers[s].name);
+    }
+    printf("\n");
+    double previous[sizeof(schedulers) / sizeof(schedulers[0])] = {0};
+    for (size_t count = 100; count <= max_pcbs; count *= 10)
+    {
+        dyn_array_t *workload = generate_workload(count, seed);
+        if (!workload)
+        {
+            fprintf(stderr, "%s:%d failed to generate %zu pcbs\n", __FILE__, __LINE__, count);
+            return EXIT_FAILURE;
+        }
+        printf("%10zu", count);
+        for (size_t s = 0; s < scheduler_count; ++s)
+        {
+            print_timing(time_scheduler(&schedulers[s], workload), &previous[s]);
+        }
+        printf("\n");
+        fflush(stdout);
+        dyn_array_destroy(workload);
+    }
+
+    printf("\n%10s", "elements");
+    for (size_t p = 0; p < primitive_count; ++p)
+    {
+        printf(" %16s", primitives[p].name);
+    }
+    printf("\n");
+    double previous_primitive[sizeof(primitives) / sizeof(primitives[0])] = {0};
+    for (size_t count = 100; count <= max_pcbs; count *= 10)
+    {
+        printf("%10zu", count);
+        for (size_t p = 0; p < primitive_count; ++p)
+        {
+            if (primitives[p].quadratic && count > QUADRATIC_LIMIT)
+            {
+                printf(" %16s", "-");
+                continue;
+            }
+            print_timing(primitives[p].run(count, seed), &previous_primitive[p]);
+        }
+        printf("\n");
+        fflush(stdout);
+    }
+    return EXIT_SUCCESS;
+}
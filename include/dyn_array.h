@@ -12,9 +12,6 @@
 #include <stdint.h>
 
 typedef struct dyn_array dyn_array_t;
-// Next version, push/pop_N_back/front for bulk loading
-// Erase_n
-// etc
 
 /*
 	Destructor notes!
@@ -44,6 +41,18 @@ typedef struct dyn_array dyn_array_t;
 ///
 dyn_array_t *dyn_array_create(const size_t capacity, const size_t data_type_size, void (*destruct_func)(void *));
 
+///
+/// Creates a new dynamic array backed by a circular buffer
+/// Behaves exactly like a regular dynamic array, but push/pop/extract at BOTH ends are O(1)
+/// Middle insertions/removals, sort, export and for_each first unwrap the buffer (O(n), once)
+/// so pointers from dyn_array_front/at/export are only contiguous until the next front operation
+/// \param capacity Minimum capacity request (0 is fine if you have no opinion)
+/// \param data_type_size Size of the object type to be stored in bytes
+/// \param destruct_func Optional destructor to be applied on destruct operations (NULL to disable)
+/// \return new dynamic array pointer, NULL on error
+///
+dyn_array_t *dyn_array_create_ring(const size_t capacity, const size_t data_type_size, void (*destruct_func)(void *));
+
 ///
 /// Creates a new dynamic array from a given array
 /// (Given pointer can be freed after import, we copy the data)
@@ -56,6 +65,110 @@ dyn_array_t *dyn_array_create(const size_t capacity, const size_t data_type_size
 dyn_array_t *dyn_array_import(const void *const data, const size_t count, const size_t data_type_size,
 							  void (*destruct_func)(void *));
 
+///
+/// Creates a new dynamic array that takes ownership of an existing heap array
+/// (Unlike import, nothing is copied. The array must come from malloc/realloc,
+///  will be realloc'd on growth and freed on destroy, so don't touch it afterwards)
+/// \param data The malloc'd data to adopt
+/// \param count Number of objects in the data, also taken as the capacity
+/// \param data_type_size The size of each object
+/// \param destruct_func Optional destructor (NULL to disable)
+/// \return new dynamic array pointer, NULL on error (data is still yours then)
+///
+dyn_array_t *dyn_array_adopt(void *const data, const size_t count, const size_t data_type_size,
+							 void (*destruct_func)(void *));
+
+///
+/// Creates a read-only dynamic array view over memory owned by someone else (e.g. a file mapping)
+/// Nothing is copied. Every operation that would modify the array fails (including dyn_array_for_each),
+/// pointers from dyn_array_at must only be read,
+/// and destroying the view leaves the data alone. The data must outlive the view.
+/// \param data The data to view
+/// \param count Number of objects in the data
+/// \param data_type_size The size of each object
+/// \return new dynamic array pointer, NULL on error
+///
+dyn_array_t *dyn_array_create_view(const void *const data, const size_t count, const size_t data_type_size);
+
+/*
+	Allocator notes!
+
+	Every byte a dynamic array owns (the struct, the storage and the scratch buffers sorts swap in)
+	  comes from its allocator. Allocators are set at creation and cannot be changed afterwards.
+
+	An allocator is a table of three functions plus a context pointer handed back to each of them.
+	realloc and free are also told the size the block was allocated with,
+	  so allocators don't need to keep headers. realloc keeps the first min(old_size, new_size) bytes
+	  and returns NULL on failure (leaving the old block alone), just like the real one.
+
+	The allocator is copied into the array, but whatever the context points at must outlive it.
+
+	Arrays made by the other create functions (and adopt/view) use dyn_default_allocator.
+*/
+typedef struct
+{
+	void *(*alloc)(void *context, const size_t size);
+	void *(*realloc)(void *context, void *ptr, const size_t old_size, const size_t new_size);
+	void (*free)(void *context, void *ptr, const size_t size);
+	void *context;
+} dyn_allocator_t;
+
+/// malloc/realloc/free
+extern const dyn_allocator_t dyn_default_allocator;
+
+///
+/// 2MB aligned mappings advised with MADV_HUGEPAGE so huge arrays get backed by huge pages
+/// (when transparent huge pages are enabled, otherwise they're just aligned mappings)
+/// Blocks under 1MB would mostly be padding, those still come from malloc
+///
+extern const dyn_allocator_t dyn_hugepage_allocator;
+
+///
+/// Creates a new dynamic array like dyn_array_create, but with all of its memory coming from allocator
+/// \param capacity Minimum capacity request (0 is fine if you have no opinion)
+/// \param data_type_size Size of the object type to be stored in bytes
+/// \param destruct_func Optional destructor to be applied on destruct operations (NULL to disable)
+/// \param allocator The allocator to use (copied, NULL for dyn_default_allocator)
+/// \return new dynamic array pointer, NULL on error
+///
+dyn_array_t *dyn_array_create_with_allocator(const size_t capacity, const size_t data_type_size,
+											 void (*destruct_func)(void *), const dyn_allocator_t *const allocator);
+
+typedef struct dyn_arena dyn_arena_t;
+
+///
+/// Creates a bump arena for batches of short-lived arrays
+/// Allocation is a pointer bump, free does nothing (unless it's the latest allocation, which is rolled back),
+/// and everything is given back at once by dyn_arena_reset/dyn_arena_destroy
+/// Arenas are not thread safe, keep each one to a single thread
+/// \param block_size Bytes to grab from malloc at a time (0 for a default of 1MB),
+///   bigger allocations get a block of their own
+/// \return new arena pointer, NULL on error
+///
+dyn_arena_t *dyn_arena_create(const size_t block_size);
+
+///
+/// Returns an allocator that draws from the arena, for dyn_array_create_with_allocator
+/// \param arena The arena
+/// \return The allocator (context is the arena)
+///
+dyn_allocator_t dyn_arena_allocator(dyn_arena_t *const arena);
+
+///
+/// Frees everything allocated from the arena but keeps its first block for the next batch
+/// Arrays made from the arena are gone afterwards, without their destructors being applied
+/// (dyn_array_destroy them first if their elements need destructing)
+/// \param arena The arena
+///
+void dyn_arena_reset(dyn_arena_t *const arena);
+
+///
+/// Frees everything allocated from the arena, and the arena itself
+/// Same caveat as dyn_arena_reset about destructors
+/// \param arena The arena
+///
+void dyn_arena_destroy(dyn_arena_t *const arena);
+
 ///
 /// Returns an internal pointer to the data array for export
 /// Since this pointer is internal, it may be invalidated by insertions that trigger reallocation
@@ -76,6 +189,7 @@ void dyn_array_destroy(dyn_array_t *const dyn_array);
 
 // Prefer the X_back functions if you use a lot of push/pop operations
 // because, duh, it's an array and arrays don't handle front operations well
+// (unless it was made with dyn_array_create_ring, then the front is just as cheap)
 
 // All insertions/extractions are via memcpy, so giving us pointers overlapping ourselves is UNDEFINED
 // The logic behind this is that you shouldn't be giving us an internal pointer that overlaps because that's weird
@@ -113,6 +227,17 @@ bool dyn_array_pop_front(dyn_array_t *const dyn_array);
 ///
 bool dyn_array_extract_front(dyn_array_t *const dyn_array, void *const object);
 
+///
+/// Removes the first count objects and places them at the desired location in order, decreasing container size by count
+/// Does not destruct since they were returned to the user
+/// Nothing is removed if there are fewer than count objects
+/// \param dyn_array the dynamic array
+/// \param objects destination for the extracted objects (room for count of them)
+/// \param count number of objects to extract
+/// \return bool representing success of the operation
+///
+bool dyn_array_extract_front_n(dyn_array_t *const dyn_array, void *const objects, const size_t count);
+
 
 
 ///
@@ -130,6 +255,16 @@ void *dyn_array_back(const dyn_array_t *const dyn_array);
 ///
 bool dyn_array_push_back(dyn_array_t *const dyn_array, const void *const object);
 
+///
+/// Copies count objects to the back of the array in order, increasing container size by count
+/// (one capacity check and one copy, not count of them)
+/// \param dyn_array the dynamic array
+/// \param objects the objects to insert
+/// \param count number of objects to insert
+/// \return bool representing success of the operation
+///
+bool dyn_array_push_back_n(dyn_array_t *const dyn_array, const void *const objects, const size_t count);
+
 ///
 /// Removes and optionally destructs the object at the back of the array
 /// \param dyn_array the dynamic array
@@ -150,6 +285,7 @@ bool dyn_array_extract_back(dyn_array_t *const dyn_array, void *const object);
 ///
 /// Returns a pointer to the desired object in the array
 /// Pointer may be invalidated if the container increases in size
+/// For a view the object is read-only; the data may be a read-only mapping, so never write through it
 /// \param dyn_array the dynamic array
 /// \param index the index of the object to retrieve
 /// \return pointer to the requested object, NULL on error
@@ -166,6 +302,18 @@ void *dyn_array_at(const dyn_array_t *const dyn_array, const size_t index);
 ///
 bool dyn_array_insert(dyn_array_t *const dyn_array, const size_t index, const void *const object);
 
+///
+/// Inserts count objects starting at the given index, increasing the container size by count
+/// and moving any contents at index and beyond down count
+/// \param dyn_array the dynamic array
+/// \param index the position to insert the first object at
+/// \param objects the objects to insert
+/// \param count number of objects to insert
+/// \return bool representing success of the operation
+///
+bool dyn_array_insert_n(dyn_array_t *const dyn_array, const size_t index, const void *const objects,
+						const size_t count);
+
 ///
 /// Removes and optionally destructs the object at the given index
 /// \param dyn_array the dynamic array
@@ -174,6 +322,16 @@ bool dyn_array_insert(dyn_array_t *const dyn_array, const size_t index, const vo
 ///
 bool dyn_array_erase(dyn_array_t *const dyn_array, const size_t index);
 
+///
+/// Removes and optionally destructs count objects starting at the given index
+/// Nothing is removed if the range runs past the end
+/// \param dyn_array the dynamic array
+/// \param index index of the first object to be erased
+/// \param count number of objects to erase
+/// \return bool representing success of the operation
+///
+bool dyn_array_erase_range(dyn_array_t *const dyn_array, const size_t index, const size_t count);
+
 ///
 /// Removes the object at the given index and places it at the desired location
 /// Does not destruct the object since it is returned to the user
@@ -212,6 +370,37 @@ size_t dyn_array_size(const dyn_array_t *const dyn_array);
 ///
 size_t dyn_array_capacity(const dyn_array_t *const dyn_array);
 
+///
+/// Makes sure the array can hold at least capacity objects without reallocating
+/// (For bulk builders, one realloc up front instead of one per doubling)
+/// \param dyn_array the dynamic array
+/// \param capacity the number of objects to make room for, exactly, no rounding up
+/// \return bool representing success of the operation (true if there was already room)
+///
+bool dyn_array_reserve(dyn_array_t *const dyn_array, const size_t capacity);
+
+///
+/// Gives back memory the array isn't using, the capacity becomes the size
+/// It's a request, if the realloc doesn't work the array is just left as it was
+/// The next growth after a shrink starts again from the create minimum, not from a capacity of 1
+/// \param dyn_array the dynamic array
+///
+void dyn_array_shrink_to_fit(dyn_array_t *const dyn_array);
+
+// Growth every new array starts with, 200 is doubling
+#define DYN_DEFAULT_GROWTH_PERCENT 200
+
+///
+/// Sets how the array manages its capacity from now on
+/// \param dyn_array the dynamic array
+/// \param growth_percent the new capacity as a percentage of the old one when it runs out of room,
+///  more than 100 (150 grows by half, trading more reallocs for less slack)
+/// \param shrink_on_drain true to halve the capacity whenever removals leave it a quarter full,
+///  so queues that fill up once and then drain give their memory back
+/// \return bool representing success of the operation
+///
+bool dyn_array_set_growth(dyn_array_t *const dyn_array, const size_t growth_percent, const bool shrink_on_drain);
+
 ///
 /// Returns the size of the object stored in the array
 /// \param dyn_array the dynamic array
@@ -232,10 +421,39 @@ size_t dyn_array_data_size(const dyn_array_t *const dyn_array);
 bool dyn_array_sort(dyn_array_t *const dyn_array, int (*const compare)(const void *, const void *));
 
 
+// Pass as the tiebreak offset of dyn_array_sort_by_u32_key to sort on the primary key alone
+#define DYN_NO_TIEBREAK ((size_t) -1)
+
+///
+/// Sorts the array by a uint32_t field inside each object, then by an optional second uint32_t field
+/// No comparator, it's an LSD radix sort with a scratch buffer: linear time and STABLE,
+/// so objects with equal keys stay in the order they were in
+/// \param dyn_array the dynamic array
+/// \param key_offset byte offset of the primary uint32_t key in each object (offsetof is your friend)
+/// \param tiebreak_offset byte offset of the uint32_t key used when primary keys are equal, or DYN_NO_TIEBREAK
+/// \return bool representing success of the operation
+///
+bool dyn_array_sort_by_u32_key(dyn_array_t *const dyn_array, const size_t key_offset, const size_t tiebreak_offset);
+
+///
+/// Sorts the array according to the given comparator function using several threads
+/// Each thread sorts a run of the array, then neighbouring runs are merged in rounds with every merge
+/// split across all the threads. Small arrays (a few thousand objects per thread) are sorted on the caller
+/// \param dyn_array the dynamic array
+/// \param compare the comparison function, same rules as dyn_array_sort
+/// \param nthreads the most threads to use, 0 for one per online CPU
+/// \param stable true to keep objects that compare equal in the order they were in (a merge sort all the way
+///  down), false lets each run be quicksorted which is a bit faster
+/// \return bool representing success of the operation
+///
+bool dyn_array_sort_parallel(dyn_array_t *const dyn_array, int (*const compare)(const void *, const void *),
+							 const size_t nthreads, const bool stable);
+
 ///
 /// Inserts the given object into the correct sorted position
 ///  increasing the container size by one
 /// and moving any contents beyond the sorted position down one
+/// The position is binary searched and comes after any equal objects, so equal objects keep their insertion order
 /// Note: calling this on an unsorted array will insert it... somewhere
 /// \param dyn_array the dynamic array
 /// \param object the object to insert
@@ -245,9 +463,22 @@ bool dyn_array_sort(dyn_array_t *const dyn_array, int (*const compare)(const voi
 bool dyn_array_insert_sorted(dyn_array_t *const dyn_array, const void *const object,
 							 int (*const compare)(const void *const, const void *const));
 
+///
+/// Inserts a batch of objects into their sorted positions, like calling dyn_array_insert_sorted on each in order
+/// but the batch is sorted (stably) and merged in with one pass over the array
+/// \param dyn_array the dynamic array (must already be sorted by compare)
+/// \param data the objects to insert, in any order (left untouched)
+/// \param count number of objects to insert
+/// \param compare the comparison function
+/// \return bool representing success of the operation
+///
+bool dyn_array_insert_sorted_many(dyn_array_t *const dyn_array, const void *const data, const size_t count,
+								  int (*const compare)(const void *const, const void *const));
+
 
 ///
 /// Applies the given function to every object in the array
+/// The function may modify the objects, so views are rejected
 /// \param dyn_array the dynamic array
 /// \param func the function to apply
 /// \param arg argument that will be passed to the function (as parameter 2)
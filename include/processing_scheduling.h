@@ -19,12 +19,79 @@ extern "C"
 		bool started;									 // If it has been activated on virtual CPU
 	} ProcessControlBlock_t;				 // you may or may not need to add more elements
 
+	typedef struct
+	{
+		uint32_t burst_time; // the burst of the pcb as stored on disk
+		uint32_t priority;	 // The priority of the task
+		uint32_t arrival;	 // Time the process arrived in the ready queue
+	} ProcessControlRecord_t; // one pcb exactly as it is laid out in the pcb file
+
+	typedef struct
+	{
+		void *mapping;		   // the whole file mapped read-only
+		size_t mapping_size;   // bytes mapped
+		dyn_array_t *records;  // read-only dyn_array view of the ProcessControlRecord_t entries in the mapping
+	} PcbFileMap_t;
+
+// records pulled from a stream per read, keeps streaming memory constant
+#define PCB_STREAM_CHUNK 4096
+
+	typedef struct
+	{
+		int fd;											  // where the records come from
+		uint32_t remaining;								  // records the header promised that are not read yet
+		size_t count;									  // valid records in chunk
+		ProcessControlRecord_t chunk[PCB_STREAM_CHUNK];	  // the most recently read records
+	} PcbStream_t;
+
+// every PcbSoA_t array starts on a boundary of this many bytes
+#define PCB_SOA_ALIGNMENT 64
+
+	typedef struct
+	{
+		size_t count;			// pcbs in the store
+		uint32_t *burst_time;	// remaining burst of each pcb
+		uint32_t *priority;		// priority of each pcb
+		uint32_t *arrival;		// arrival of each pcb
+		uint64_t *started;		// bit i is set once pcb i has been on the virtual CPU
+		void *block;			// the one allocation behind the arrays
+	} PcbSoA_t; // the same pcbs as a dyn_array of ProcessControlBlock_t, one field per array
+
 	typedef struct
 	{
 		float average_waiting_time;		 // the average waiting time in the ready queue until first schedue on the cpu
 		float average_turnaround_time; // the average completion time of the PCBs
 		unsigned long total_run_time;	 // the total time to process all the PCBs in the ready queue
 	} ScheduleResult_t;
+
+// the most levels a multi-level feedback queue can have, one bit of a uint64_t each
+#define MLFQ_MAX_LEVELS 64
+
+	typedef struct
+	{
+		size_t levels;		   // number of levels, 1 to MLFQ_MAX_LEVELS, level 0 runs first
+		const size_t *quanta;  // time a process may use on each level before it is demoted, every one > 0
+		size_t boost_interval; // every boost_interval time units all processes go back to level 0, 0 never boosts
+	} MlfqConfig_t;
+
+	typedef enum
+	{
+		STEAL_RANDOM_VICTIM, // an idle core takes from a random core with queued processes
+		STEAL_MOST_LOADED	 // an idle core takes from the core with the most queued burst time
+	} StealPolicy_t;
+
+	typedef struct
+	{
+		size_t cores;		 // simulated CPUs, at least 1
+		StealPolicy_t steal; // how an idle core picks the core it takes a process from
+		uint64_t seed;		 // seeds the random victims, the same seed gives the same schedule
+	} MultiCoreConfig_t;
+
+	typedef struct
+	{
+		size_t target_latency;	// time in which every runnable process should get a slice, > 0
+		size_t min_granularity; // shortest slice, once more processes are runnable than fit in target_latency, > 0
+	} CfsConfig_t;
 	// comaprison for priority using the dynamic array sort function
 	// \param a is first value
 	// \param b is second value
@@ -48,12 +115,90 @@ extern "C"
 	// \return a populated dyn_array of ProcessControlBlocks if function ran successful else NULL for an error
 	dyn_array_t *load_process_control_blocks(const char *input_file);
 
+	// Opens a pcb file (or "-" for stdin, so pipes work) for reading in chunks of PCB_STREAM_CHUNK records
+	// Only the header is read here, nothing needs to be seekable
+	// \param input_file the file containing the PCBs, "-" for stdin
+	// \param stream the stream to set up, release with close_process_control_stream
+	// \return true if the header was read else false for an error
+	bool open_process_control_stream(const char *input_file, PcbStream_t *stream);
+
+	// Reads the next chunk of records into stream->chunk and sets stream->count
+	// \param stream the open stream
+	// \return true if a chunk was read, false at the end of the records or on a short/failed read
+	//         (stream->remaining is 0 only for a clean end)
+	bool read_process_control_chunk(PcbStream_t *stream);
+
+	// Closes a stream opened by open_process_control_stream
+	// \param stream the stream to close
+	void close_process_control_stream(PcbStream_t *stream);
+
+	// Maps a pcb file into memory and exposes its records without copying them
+	// The header and file size are validated once up front. The schedulers take ProcessControlBlock_t,
+	// so running them on the records still means a full copy (process_control_blocks_from_records);
+	// load_process_control_blocks gets there with less peak memory
+	// \param input_file the file containing the PCBs
+	// \param map filled with the mapping and a read-only view of ProcessControlRecord_t, release with unmap_process_control_blocks
+	// \return true if the file was mapped else false for an error
+	bool map_process_control_blocks(const char *input_file, PcbFileMap_t *map);
+
+	// Releases a mapping made by map_process_control_blocks, the records view is destroyed with it
+	// \param map the mapping to release
+	void unmap_process_control_blocks(PcbFileMap_t *map);
+
+	// Copies a set of on-disk records into a new ProcessControlBlock_t array in one allocation
+	// Every field is copied, 16 bytes per pcb next to the 12 byte records
+	// \param records a dyn_array of ProcessControlRecord_t (such as PcbFileMap_t records)
+	// \return a populated dyn_array of ProcessControlBlocks if function ran successful else NULL for an error
+	dyn_array_t *process_control_blocks_from_records(const dyn_array_t *records);
+
+	// Allocates a store for count pcbs, every field starts at zero
+	// \param count the number of pcbs
+	// \param soa the store to set up, release with pcb_soa_destroy
+	// \return true if the store was allocated else false for an error
+	bool pcb_soa_create(size_t count, PcbSoA_t *soa);
+
+	// Frees a store made by pcb_soa_create or load_process_control_soa
+	// \param soa the store to free
+	void pcb_soa_destroy(PcbSoA_t *soa);
+
+	// Reads a pcb file (or "-" for stdin) straight into a structure of arrays store, a chunk of records at a time
+	// \param input_file the file containing the PCBs
+	// \param soa the store to fill, release with pcb_soa_destroy
+	// \return true if the file was loaded else false for an error
+	bool load_process_control_soa(const char *input_file, PcbSoA_t *soa);
+
+	// Copies a dyn_array of ProcessControlBlock_t into a new structure of arrays store
+	// \param pcbs the blocks to copy
+	// \param soa the store to fill, release with pcb_soa_destroy
+	// \return true if the store was filled else false for an error
+	bool pcb_soa_from_blocks(const dyn_array_t *pcbs, PcbSoA_t *soa);
+
+	// Sets how many threads First Come First Served, Shortest Job First and Priority may split the metric pass
+	// and the sort of a large ready queue across, results are the same for any setting
+	// \param threads 0 for one per core (the default), 1 to always run serially
+	void set_scheduler_threads(size_t threads);
+
+// default ready queue size for sorting with dyn_array_sort_parallel
+#define SCHEDULER_PARALLEL_SORT_THRESHOLD ((size_t) 1 << 20)
+
+	// Sets the ready queue size from which the schedulers sort with dyn_array_sort_parallel instead of the
+	// serial radix sort, only when there are enough threads for it to win (see set_scheduler_threads)
+	// \param pcbs the smallest ready queue to sort in parallel, SCHEDULER_PARALLEL_SORT_THRESHOLD by default
+	void set_scheduler_parallel_sort_threshold(size_t pcbs);
+
 	// Runs the First Come First Served Process Scheduling algorithm over the incoming ready_queue
 	// \param ready queue a dyn_array of type ProcessControlBlock_t that contain be up to N elements
 	// \param result used for first come first served stat tracking \ref ScheduleResult_t
 	// \return true if function ran successful else false for an error
 	bool first_come_first_serve(dyn_array_t *ready_queue, ScheduleResult_t *result);
 
+	// Runs First Come First Served over records as they are read from a stream, memory stays constant
+	// The records must already be in arrival order since nothing is kept around to sort
+	// \param stream a freshly opened stream \ref open_process_control_stream
+	// \param result used for first come first served stat tracking \ref ScheduleResult_t
+	// \return true if function ran successful else false for an error (including out of order arrivals)
+	bool first_come_first_serve_stream(PcbStream_t *stream, ScheduleResult_t *result);
+
 	// Runs the Shortest Job First Scheduling algorithm over the incoming ready_queue
 	// \param ready queue a dyn_array of type ProcessControlBlock_t that contain be up to N elements
 	// \param result used for shortest job first stat tracking \ref ScheduleResult_t
@@ -66,6 +211,26 @@ extern "C"
 	// \return true if function ran successful else false for an error
 	bool priority(dyn_array_t *ready_queue, ScheduleResult_t *result);
 
+	// Shortest Job First and Priority that only ever pick from the processes that have arrived
+	// shortest_job_first and priority sort the whole queue up front, so on staggered arrivals they run processes
+	// before they exist. These walk the queue in arrival order and keep the arrived processes in a heap,
+	// O(n log n) with the heap no bigger than the ready set. Ties go to the earlier arrival, then queue order.
+	// \param ready queue a dyn_array of type ProcessControlBlock_t that contain be up to N elements
+	// \param result used for stat tracking \ref ScheduleResult_t, total_run_time is when the last process finished
+	// \return true if function ran successful else false for an error
+	bool shortest_job_first_arrival_aware(dyn_array_t *ready_queue, ScheduleResult_t *result);
+	bool priority_arrival_aware(dyn_array_t *ready_queue, ScheduleResult_t *result);
+
+	// First Come First Served, Shortest Job First and Priority over a structure of arrays store
+	// The store is reordered into run order the same way the dyn_array versions sort their ready_queue,
+	// and the results match them
+	// \param soa the pcbs \ref PcbSoA_t
+	// \param result used for stat tracking \ref ScheduleResult_t
+	// \return true if function ran successful else false for an error
+	bool first_come_first_serve_soa(PcbSoA_t *soa, ScheduleResult_t *result);
+	bool shortest_job_first_soa(PcbSoA_t *soa, ScheduleResult_t *result);
+	bool priority_soa(PcbSoA_t *soa, ScheduleResult_t *result);
+
 	// Runs the Round Robin Process Scheduling algorithm over the incoming ready_queue
 	// \param ready queue a dyn_array of type ProcessControlBlock_t that contain be up to N elements
 	// \param result used for round robin stat tracking \ref ScheduleResult_t
@@ -79,6 +244,50 @@ extern "C"
 	// \return true if function ran successful else false for an error
 	bool shortest_remaining_time_first(dyn_array_t *ready_queue, ScheduleResult_t *result);
 
+	// Runs preemptive Priority with aging over the incoming ready_queue
+	// A process's effective priority improves by one level (towards 0) for every aging_interval it has spent waiting,
+	// the running process keeps the effective priority it was dispatched with and is only preempted by a strictly
+	// better one. Simulated event by event, waiting processes are never rescanned.
+	// \param ready queue a dyn_array of type ProcessControlBlock_t that contain be up to N elements
+	// \param result used for stat tracking \ref ScheduleResult_t, total_run_time is when the last process finished
+	// \param aging_interval time waited per level of improvement, 0 disables aging (at most UINT32_MAX)
+	// \return true if function ran successful else false for an error
+	bool preemptive_priority(dyn_array_t *ready_queue, ScheduleResult_t *result, size_t aging_interval);
+
+	// Runs a Multi-Level Feedback Queue over the incoming ready_queue
+	// Arrivals join level 0, each level is round robin and runs only when every better level is empty.
+	// A process that uses up its level's quantum (in one slice or several) moves one level down,
+	// an arrival preempts a process running below level 0 and the preempted one resumes first on its level.
+	// \param ready queue a dyn_array of type ProcessControlBlock_t that contain be up to N elements
+	// \param result used for stat tracking \ref ScheduleResult_t, total_run_time is when the last process finished
+	// \param config the levels, their quanta and the boost interval \ref MlfqConfig_t
+	// \return true if function ran successful else false for an error
+	bool multi_level_feedback_queue(dyn_array_t *ready_queue, ScheduleResult_t *result, const MlfqConfig_t *config);
+
+	// Runs First Come First Serve on config->cores CPUs over the incoming ready_queue
+	// Each core has its own FIFO, process i in arrival order is queued on core i % cores, and an idle core
+	// starts it straight away. A core runs its FIFO from the front, each process to completion, and when
+	// its FIFO is empty it steals the newest process from a victim picked by config->steal.
+	// \param ready queue a dyn_array of type ProcessControlBlock_t that contain be up to N elements
+	// \param result wait and turnaround over every process, total_run_time is when the last process finished
+	// \param config the cores and how they steal \ref MultiCoreConfig_t
+	// \param core_utilization when not NULL gets config->cores entries, the fraction of total_run_time each core was busy
+	// \return true if function ran successful else false for an error
+	bool multi_core_first_come_first_serve(dyn_array_t *ready_queue, ScheduleResult_t *result,
+										   const MultiCoreConfig_t *config, float *core_utilization);
+
+	// Runs a Completely Fair Scheduler over the incoming ready_queue
+	// The runnable process with the least virtual runtime (CPU time scaled by 1024 / weight) runs next, for its
+	// weighted share of the scheduling period. The period is target_latency, or min_granularity per runnable
+	// process when that is longer. Weights come from priority like Linux nice levels: 0 weighs like nice -20, 20 like
+	// nice 0, 39 and above like nice 19. Arrivals start at the smallest virtual runtime and wait for the slice
+	// in progress to end.
+	// \param ready queue a dyn_array of type ProcessControlBlock_t that contain be up to N elements
+	// \param result used for stat tracking \ref ScheduleResult_t, total_run_time is when the last process finished
+	// \param config the target latency and minimum granularity \ref CfsConfig_t
+	// \return true if function ran successful else false for an error
+	bool completely_fair(dyn_array_t *ready_queue, ScheduleResult_t *result, const CfsConfig_t *config);
+
 #ifdef __cplusplus
 }
 #endif
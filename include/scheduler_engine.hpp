@@ -0,0 +1,1518 @@
+#ifndef SCHEDULER_ENGINE_HPP
+#define SCHEDULER_ENGINE_HPP
+
+// Header-only scheduler engine
+// A scheduling policy is a type made out of an ordering, a report for total run time and a few traits,
+// the engines are templates on that type. Everything is known at compile time, so the comparisons in the
+// heaps inline and there are no function pointers or dyn_array_at bounds checks in the hot loops.
+// The C entry points in processing_scheduling.h are thin wrappers around the instantiations at the bottom.
+//
+// Engines assume their arguments were validated (non-NULL, non-empty, quantum > 0), the wrappers do that.
+// The parameter every engine takes is the policy's: the quantum for time slicing, the aging interval
+// for aging, the MlfqConfig_t for feedback queues, a MultiCoreRun for several cores, the CfsConfig_t for
+// fair share, unused otherwise.
+// They may throw std::bad_alloc, the wrappers turn that into false.
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <deque>
+#include <functional>
+#include <queue>
+#include <set>
+#include <vector>
+
+#include "processing_scheduling.h"
+
+namespace scheduler_engine
+{
+
+//
+// Orderings: how ready processes are ranked
+// key_offset/tiebreak_offset feed the radix sort, less is the same order for heaps,
+// soa_key/soa_tiebreak name the same fields of a PcbSoA_t
+//
+
+// the uint32 fields of a PcbSoA_t
+enum SoaField
+{
+    SOA_BURST_TIME,
+    SOA_PRIORITY,
+    SOA_ARRIVAL,
+    SOA_FIELDS,
+    SOA_NO_FIELD = SOA_FIELDS
+};
+
+struct ByArrival
+{
+    static const size_t key_offset = offsetof(ProcessControlBlock_t, arrival);
+    static const size_t tiebreak_offset = DYN_NO_TIEBREAK;
+    static bool less(const ProcessControlBlock_t *a, const ProcessControlBlock_t *b)
+    {
+        return a->arrival < b->arrival;
+    }
+    static const int soa_key = SOA_ARRIVAL;
+    static const int soa_tiebreak = SOA_NO_FIELD;
+};
+
+struct ByBurst
+{
+    static const size_t key_offset = offsetof(ProcessControlBlock_t, remaining_burst_time);
+    static const size_t tiebreak_offset = offsetof(ProcessControlBlock_t, arrival);
+    static bool less(const ProcessControlBlock_t *a, const ProcessControlBlock_t *b)
+    {
+        return a->remaining_burst_time != b->remaining_burst_time ? a->remaining_burst_time < b->remaining_burst_time
+                                                                  : a->arrival < b->arrival;
+    }
+    static const int soa_key = SOA_BURST_TIME;
+    static const int soa_tiebreak = SOA_ARRIVAL;
+};
+
+struct ByPriority
+{
+    static const size_t key_offset = offsetof(ProcessControlBlock_t, priority);
+    static const size_t tiebreak_offset = offsetof(ProcessControlBlock_t, arrival);
+    static bool less(const ProcessControlBlock_t *a, const ProcessControlBlock_t *b)
+    {
+        return a->priority != b->priority ? a->priority < b->priority : a->arrival < b->arrival;
+    }
+    static const int soa_key = SOA_PRIORITY;
+    static const int soa_tiebreak = SOA_ARRIVAL;
+};
+
+// Order with ties left to the pcbs' positions in the ready queue, so heaps pop equal pcbs in queue order
+template <class Order>
+struct QueueStable
+{
+    static bool less(const ProcessControlBlock_t *a, const ProcessControlBlock_t *b)
+    {
+        return Order::less(a, b) || (!Order::less(b, a) && a < b);
+    }
+};
+
+// Order::less as a comparator for the dyn_array sorts
+template <class Order>
+inline int order_compare(const void *a, const void *b)
+{
+    const ProcessControlBlock_t *pcb_a = static_cast<const ProcessControlBlock_t *>(a);
+    const ProcessControlBlock_t *pcb_b = static_cast<const ProcessControlBlock_t *>(b);
+    return Order::less(pcb_a, pcb_b) ? -1 : Order::less(pcb_b, pcb_a);
+}
+
+// threads the scheduler passes and sorts may use, set_scheduler_threads picks it, 0 resolves to one per core
+size_t pass_threads();
+void set_pass_threads(size_t threads);
+
+// ready queues from this many pcbs are sorted in parallel, set_scheduler_parallel_sort_threshold picks it
+size_t parallel_sort_threshold();
+void set_parallel_sort_threshold(size_t pcbs);
+
+// The linear-time radix sort beats a parallel merge sort until there are this many threads to share the n log n
+const size_t parallel_sort_min_threads = 8;
+
+// sorts a ready queue into Order, stable either way
+template <class Order>
+inline bool sort_ready_queue(dyn_array_t *ready_queue)
+{
+    size_t threads = pass_threads();
+    if (threads >= parallel_sort_min_threads && dyn_array_size(ready_queue) >= parallel_sort_threshold())
+    {
+        return dyn_array_sort_parallel(ready_queue, order_compare<Order>, threads, true);
+    }
+    return dyn_array_sort_by_u32_key(ready_queue, Order::key_offset, Order::tiebreak_offset);
+}
+
+//
+// Metric collection
+//
+
+struct Totals
+{
+    unsigned long total_wait_time;
+    unsigned long total_turnaround_time;
+    unsigned long total_burst_time;
+    unsigned long last_completion;
+    size_t count;
+
+    Totals() : total_wait_time(0), total_turnaround_time(0), total_burst_time(0), last_completion(0), count(0) {}
+
+    // a process that arrived at arrival, needed burst_time on the CPU and was done at completion
+    void complete(unsigned long arrival, unsigned long burst_time, unsigned long completion)
+    {
+        total_turnaround_time += completion - arrival;
+        total_wait_time += completion - arrival - burst_time;
+        total_burst_time += burst_time;
+        last_completion = completion > last_completion ? completion : last_completion;
+        ++count;
+    }
+};
+
+// What each policy has always reported as total_run_time
+struct RunTimeIsBusyTime  // time the CPU spent running processes
+{
+    static unsigned long report(const Totals &totals) { return totals.total_burst_time; }
+};
+
+struct RunTimeIsMakespan  // when the last process finished
+{
+    static unsigned long report(const Totals &totals) { return totals.last_completion; }
+};
+
+struct RunTimeIsTurnaroundSum  // sum of every turnaround time
+{
+    static unsigned long report(const Totals &totals) { return totals.total_turnaround_time; }
+};
+
+template <class RunTime>
+inline void report(const Totals &totals, ScheduleResult_t *result)
+{
+    result->average_waiting_time = totals.count ? (float)totals.total_wait_time / totals.count : 0.0f;
+    result->average_turnaround_time = totals.count ? (float)totals.total_turnaround_time / totals.count : 0.0f;
+    result->total_run_time = RunTime::report(totals);
+}
+
+//
+// Policies
+//
+
+struct non_preemptive_tag {};
+struct arrival_aware_tag {};
+struct preemptive_tag {};
+struct time_sliced_tag {};
+struct aging_tag {};
+struct feedback_queue_tag {};
+struct multi_core_tag {};
+struct fair_tag {};
+
+// Runs processes to completion in Order
+// IdleJumpsToArrival: false keeps FCFS's accounting, which never lets the CPU sit idle waiting for an arrival
+template <class Order, class RunTime, bool IdleJumpsToArrival>
+struct NonPreemptivePolicy
+{
+    typedef non_preemptive_tag engine;
+    typedef Order order;
+    typedef RunTime run_time;
+    static const bool idle_jumps_to_arrival = IdleJumpsToArrival;
+};
+
+// Runs the best arrived process in Order to completion, an idle CPU waits for the next arrival
+template <class Order, class RunTime>
+struct ArrivalAwarePolicy
+{
+    typedef arrival_aware_tag engine;
+    typedef Order order;
+    typedef RunTime run_time;
+};
+
+// Always runs the best arrived process in Order, a better arrival preempts the running one
+template <class Order, class RunTime>
+struct PreemptivePolicy
+{
+    typedef preemptive_tag engine;
+    typedef Order order;
+    typedef RunTime run_time;
+};
+
+// Arrived processes take turns in a FIFO, a quantum at a time
+template <class RunTime>
+struct TimeSlicedPolicy
+{
+    typedef time_sliced_tag engine;
+    typedef RunTime run_time;
+};
+
+// Preemptive priority where waiting improves a process's effective priority
+// (see the aging engine), the running process only loses the CPU to a strictly better one
+template <class RunTime>
+struct AgingPolicy
+{
+    typedef aging_tag engine;
+    typedef RunTime run_time;
+};
+
+// Round robin levels, a process sinks a level each time it uses up a level's quantum
+// and periodic boosts lift every process back to the top
+template <class RunTime>
+struct FeedbackQueuePolicy
+{
+    typedef feedback_queue_tag engine;
+    typedef RunTime run_time;
+};
+
+// Several cores, each runs its own FIFO to completion and steals when it runs dry
+template <class RunTime>
+struct MultiCorePolicy
+{
+    typedef multi_core_tag engine;
+    typedef RunTime run_time;
+};
+
+// Runs the process that has had the least CPU time for its weight, each for its share of a period
+template <class RunTime>
+struct FairPolicy
+{
+    typedef fair_tag engine;
+    typedef RunTime run_time;
+};
+
+//
+// Engines
+//
+
+//
+// Completion-time kernel
+// In run order every non-preemptive policy is the same scan: start = max(CPU free, arrival),
+// wait = start - arrival, the CPU is free again at start + burst. The kernels in completion_kernel.cpp
+// run it as a max-plus prefix scan in SIMD lanes, completion_pass picks the best one this CPU has.
+//
+
+struct CompletionState
+{
+    unsigned long current_time;  // when the CPU is free for the next process
+    unsigned long total_wait_time;
+    unsigned long total_burst_time;
+    unsigned long last_completion;
+    size_t count;
+};
+
+// Accounts for n pcbs in run order, burst_time[i * stride] and arrival[i * stride]
+// idle_jumps_to_arrival: false is FCFS's accounting, current_time only ever advances by bursts
+typedef void (*completion_kernel_t)(const uint32_t *burst_time, const uint32_t *arrival, size_t n, size_t stride,
+                                    bool idle_jumps_to_arrival, CompletionState *state);
+
+void completion_kernel_scalar(const uint32_t *burst_time, const uint32_t *arrival, size_t n, size_t stride,
+                              bool idle_jumps_to_arrival, CompletionState *state);
+// the SIMD kernels need stride 1 and a CPU that has the instructions, NULL when they were not built
+extern const completion_kernel_t completion_kernel_sse4;
+extern const completion_kernel_t completion_kernel_avx2;
+
+// the fastest kernel for contiguous fields on this CPU, picked once
+completion_kernel_t completion_kernel();
+
+// runs the fastest kernel that handles stride
+inline void completion_pass_serial(const uint32_t *burst_time, const uint32_t *arrival, size_t n, size_t stride,
+                                   bool idle_jumps_to_arrival, CompletionState *state)
+{
+    (stride == 1 ? completion_kernel() : completion_kernel_scalar)(burst_time, arrival, n, stride, idle_jumps_to_arrival,
+                                                                   state);
+}
+
+// Splits the pass into one block per thread. A block maps the time the CPU is free when it starts, cur,
+// to max(cur + its bursts, its finish when started at 0) (just cur + its bursts for FCFS). Those summaries
+// are found in parallel and combined in order, then every block is accounted in parallel from its real start.
+void completion_pass_parallel(const uint32_t *burst_time, const uint32_t *arrival, size_t n, size_t stride,
+                              bool idle_jumps_to_arrival, CompletionState *state, size_t threads);
+
+// each thread needs this many pcbs before splitting beats a serial pass
+const size_t parallel_pass_min_per_thread = 1 << 16;
+
+inline void completion_pass(const uint32_t *burst_time, const uint32_t *arrival, size_t n, size_t stride,
+                            bool idle_jumps_to_arrival, CompletionState *state)
+{
+    size_t threads = n / parallel_pass_min_per_thread;
+    if (threads > 1)
+    {
+        size_t available = pass_threads();
+        threads = threads < available ? threads : available;
+    }
+    if (threads > 1)
+    {
+        completion_pass_parallel(burst_time, arrival, n, stride, idle_jumps_to_arrival, state, threads);
+    }
+    else
+    {
+        completion_pass_serial(burst_time, arrival, n, stride, idle_jumps_to_arrival, state);
+    }
+}
+
+// One block of processes at a time in the order they will run, shared by the array, stream and SoA versions
+template <class Policy>
+class NonPreemptivePass
+{
+  public:
+    NonPreemptivePass()
+    {
+        CompletionState empty = {0, 0, 0, 0, 0};
+        state_ = empty;
+    }
+
+    // the next n processes in run order, stride counts uint32 fields between one process and the next
+    void account(const uint32_t *burst_time, const uint32_t *arrival, size_t n, size_t stride)
+    {
+        completion_pass(burst_time, arrival, n, stride, Policy::idle_jumps_to_arrival, &state_);
+    }
+
+    void report(ScheduleResult_t *result) const
+    {
+        Totals totals;
+        totals.total_wait_time = state_.total_wait_time;
+        totals.total_turnaround_time = state_.total_wait_time + state_.total_burst_time;
+        totals.total_burst_time = state_.total_burst_time;
+        totals.last_completion = state_.last_completion;
+        totals.count = state_.count;
+        scheduler_engine::report<typename Policy::run_time>(totals, result);
+    }
+
+    size_t count() const { return state_.count; }
+
+  private:
+    CompletionState state_;
+};
+
+template <class Policy>
+inline bool run(dyn_array_t *ready_queue, ScheduleResult_t *result, size_t, non_preemptive_tag)
+{
+    if (!sort_ready_queue<typename Policy::order>(ready_queue))
+    {
+        return false;
+    }
+    const ProcessControlBlock_t *pcbs = static_cast<const ProcessControlBlock_t *>(dyn_array_export(ready_queue));
+    NonPreemptivePass<Policy> pass;
+    pass.account(&pcbs[0].remaining_burst_time, &pcbs[0].arrival, dyn_array_size(ready_queue),
+                 sizeof(ProcessControlBlock_t) / sizeof(uint32_t));
+    pass.report(result);
+    return true;
+}
+
+//
+// Structure of arrays stores
+//
+
+// One stable LSD pass over the byte at shift of fields[digit_field], every field moves with its pcb.
+// order (when there is one) tracks where each pcb came from so bits without a field can follow.
+// \return false when every pcb shares that byte and nothing moved, else the pass is in spare
+inline bool soa_radix_pass(uint32_t *const *fields, uint32_t *const *spare, int digit_field, unsigned shift, size_t n,
+                           const uint32_t *order, uint32_t *order_spare)
+{
+    const uint32_t *digits = fields[digit_field];
+    size_t counts[256] = {0};
+    for (size_t i = 0; i < n; ++i)
+    {
+        ++counts[(digits[i] >> shift) & 0xFF];
+    }
+    if (counts[(digits[0] >> shift) & 0xFF] == n)
+    {
+        return false;
+    }
+    size_t offset = 0;
+    for (size_t digit = 0; digit < 256; ++digit)
+    {
+        size_t count = counts[digit];
+        counts[digit] = offset;
+        offset += count;
+    }
+    for (size_t i = 0; i < n; ++i)
+    {
+        size_t slot = counts[(digits[i] >> shift) & 0xFF]++;
+        spare[SOA_BURST_TIME][slot] = fields[SOA_BURST_TIME][i];
+        spare[SOA_PRIORITY][slot] = fields[SOA_PRIORITY][i];
+        spare[SOA_ARRIVAL][slot] = fields[SOA_ARRIVAL][i];
+        if (order)
+        {
+            order_spare[slot] = order[i];
+        }
+    }
+    return true;
+}
+
+template <class Order>
+inline bool soa_is_sorted(const PcbSoA_t *soa)
+{
+    const uint32_t *fields[SOA_FIELDS] = {soa->burst_time, soa->priority, soa->arrival};
+    const uint32_t *key = fields[Order::soa_key];
+    const uint32_t *tiebreak = Order::soa_tiebreak == SOA_NO_FIELD ? NULL : fields[Order::soa_tiebreak];
+    for (size_t i = 1; i < soa->count; ++i)
+    {
+        if (key[i] < key[i - 1] || (tiebreak && key[i] == key[i - 1] && tiebreak[i] < tiebreak[i - 1]))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Stable sort of the store into Order
+// The passes move all three fields at once, so each pass reads and writes contiguous arrays,
+// and started bits are only tracked through the sort when one is set
+template <class Order>
+inline void sort_ready_queue(PcbSoA_t *soa)
+{
+    if (soa_is_sorted<Order>(soa))
+    {
+        return;
+    }
+    const size_t n = soa->count;
+    const size_t words = (n + 63) / 64;
+    bool any_started = false;
+    for (size_t w = 0; w < words && !any_started; ++w)
+    {
+        any_started = soa->started[w] != 0;
+    }
+
+    std::vector<uint32_t> scratch(SOA_FIELDS * n);
+    uint32_t *fields[SOA_FIELDS] = {soa->burst_time, soa->priority, soa->arrival};
+    uint32_t *spare[SOA_FIELDS] = {&scratch[0], &scratch[n], &scratch[2 * n]};
+    std::vector<uint32_t> order(any_started ? n : 0);
+    std::vector<uint32_t> order_spare(any_started ? n : 0);
+    for (size_t i = 0; i < order.size(); ++i)
+    {
+        order[i] = (uint32_t)i;
+    }
+
+    // least significant first: the tiebreak, then the key
+    const int digit_fields[] = {Order::soa_tiebreak, Order::soa_key};
+    for (size_t d = 0; d < 2; ++d)
+    {
+        for (unsigned shift = 0; digit_fields[d] != SOA_NO_FIELD && shift < 32; shift += 8)
+        {
+            if (soa_radix_pass(fields, spare, digit_fields[d], shift, n, any_started ? &order[0] : NULL,
+                               any_started ? &order_spare[0] : NULL))
+            {
+                for (size_t f = 0; f < SOA_FIELDS; ++f)
+                {
+                    uint32_t *swap = fields[f];
+                    fields[f] = spare[f];
+                    spare[f] = swap;
+                }
+                order.swap(order_spare);
+            }
+        }
+    }
+
+    // an odd number of passes leaves the result in the scratch arrays
+    if (fields[SOA_BURST_TIME] != soa->burst_time)
+    {
+        memcpy(soa->burst_time, fields[SOA_BURST_TIME], n * sizeof(uint32_t));
+        memcpy(soa->priority, fields[SOA_PRIORITY], n * sizeof(uint32_t));
+        memcpy(soa->arrival, fields[SOA_ARRIVAL], n * sizeof(uint32_t));
+    }
+    if (any_started)
+    {
+        std::vector<uint64_t> started(words, 0);
+        for (size_t i = 0; i < n; ++i)
+        {
+            started[i / 64] |= ((soa->started[order[i] / 64] >> (order[i] % 64)) & 1ULL) << (i % 64);
+        }
+        memcpy(soa->started, &started[0], words * sizeof(uint64_t));
+    }
+}
+
+// Same pass as the dyn_array version, but burst and arrival are two contiguous streams the SIMD kernels can load
+template <class Policy>
+inline bool run(PcbSoA_t *soa, ScheduleResult_t *result, size_t, non_preemptive_tag)
+{
+    sort_ready_queue<typename Policy::order>(soa);
+    NonPreemptivePass<Policy> pass;
+    pass.account(soa->burst_time, soa->arrival, soa->count, 1);
+    pass.report(result);
+    return true;
+}
+
+// Binary min-heap of pcb pointers, Order::less inlines into the sifts
+template <class Order>
+class ReadyHeap
+{
+  public:
+    explicit ReadyHeap(size_t capacity) { nodes_.reserve(capacity); }
+
+    bool empty() const { return nodes_.empty(); }
+    size_t size() const { return nodes_.size(); }
+    ProcessControlBlock_t *top() const { return nodes_.front(); }
+
+    void push(ProcessControlBlock_t *pcb)
+    {
+        nodes_.push_back(pcb);
+        sift_up(nodes_.size() - 1);
+    }
+
+    ProcessControlBlock_t *pop()
+    {
+        ProcessControlBlock_t *top_pcb = nodes_.front();
+        nodes_.front() = nodes_.back();
+        nodes_.pop_back();
+        if (!nodes_.empty())
+        {
+            sift_down(0);
+        }
+        return top_pcb;
+    }
+
+    // call after the top's key got better (or stayed the same), nothing has to move
+    void top_improved() {}
+
+    // call after the top's key got worse
+    void top_worsened() { sift_down(0); }
+
+  private:
+    void sift_up(size_t idx)
+    {
+        ProcessControlBlock_t *pcb = nodes_[idx];
+        while (idx > 0)
+        {
+            size_t parent = (idx - 1) >> 1;
+            if (!Order::less(pcb, nodes_[parent]))
+            {
+                break;
+            }
+            nodes_[idx] = nodes_[parent];
+            idx = parent;
+        }
+        nodes_[idx] = pcb;
+    }
+
+    void sift_down(size_t idx)
+    {
+        const size_t size = nodes_.size();
+        ProcessControlBlock_t *pcb = nodes_[idx];
+        for (;;)
+        {
+            size_t child = (idx << 1) + 1;
+            if (child >= size)
+            {
+                break;
+            }
+            if (child + 1 < size && Order::less(nodes_[child + 1], nodes_[child]))
+            {
+                ++child;
+            }
+            if (!Order::less(nodes_[child], pcb))
+            {
+                break;
+            }
+            nodes_[idx] = nodes_[child];
+            idx = child;
+        }
+        nodes_[idx] = pcb;
+    }
+
+    std::vector<ProcessControlBlock_t *> nodes_;
+};
+
+// Event driven: time jumps straight to the next arrival or completion
+template <class Policy>
+inline bool run(dyn_array_t *ready_queue, ScheduleResult_t *result, size_t, preemptive_tag)
+{
+    // Not-yet-arrived processes are consumed from the front of the arrival ordered queue
+    if (!sort_ready_queue<ByArrival>(ready_queue))
+    {
+        return false;
+    }
+    ProcessControlBlock_t *pcbs = static_cast<ProcessControlBlock_t *>(dyn_array_at(ready_queue, 0));
+    const size_t n = dyn_array_size(ready_queue);
+
+    // original bursts, remaining_burst_time counts down as the processes run
+    std::vector<uint32_t> bursts(n);
+    for (size_t i = 0; i < n; ++i)
+    {
+        bursts[i] = pcbs[i].remaining_burst_time;
+    }
+
+    ReadyHeap<typename Policy::order> heap(n);
+    Totals totals;
+    unsigned long current_time = 0;
+    size_t next_arrival = 0;
+
+    while (next_arrival < n || !heap.empty())
+    {
+        // CPU is idle, jump straight to the next arrival
+        if (heap.empty() && current_time < pcbs[next_arrival].arrival)
+        {
+            current_time = pcbs[next_arrival].arrival;
+        }
+
+        // Move everything that has arrived by now into the heap
+        while (next_arrival < n && pcbs[next_arrival].arrival <= current_time)
+        {
+            heap.push(&pcbs[next_arrival++]);
+        }
+
+        // The best process runs until it completes or the next arrival
+        ProcessControlBlock_t *current_process = heap.top();
+        current_process->started = true;
+        unsigned long finish_time = current_time + current_process->remaining_burst_time;
+
+        if (next_arrival < n && pcbs[next_arrival].arrival < finish_time)
+        {
+            // Preemption point, running only ever improves the key of the top
+            current_process->remaining_burst_time -= pcbs[next_arrival].arrival - current_time;
+            current_time = pcbs[next_arrival].arrival;
+            heap.top_improved();
+        }
+        else
+        {
+            current_process->remaining_burst_time = 0;
+            current_time = finish_time;
+            totals.complete(current_process->arrival, bursts[current_process - pcbs], current_time);
+            heap.pop();
+        }
+    }
+
+    report<typename Policy::run_time>(totals, result);
+    return true;
+}
+
+// Walks the processes in arrival order, each one joins the heap when it has arrived by the time the CPU
+// is next free, and the best of the heap runs to completion. The heap only ever holds the ready set.
+template <class Policy>
+inline bool run(dyn_array_t *ready_queue, ScheduleResult_t *result, size_t, arrival_aware_tag)
+{
+    if (!sort_ready_queue<ByArrival>(ready_queue))
+    {
+        return false;
+    }
+    ProcessControlBlock_t *pcbs = static_cast<ProcessControlBlock_t *>(dyn_array_at(ready_queue, 0));
+    const size_t n = dyn_array_size(ready_queue);
+
+    // ties go to the earlier pcb in the (stable) arrival order, same as the sorted versions
+    // the heap grows to the largest ready set instead of reserving n
+    ReadyHeap<QueueStable<typename Policy::order> > heap(0);
+    Totals totals;
+    unsigned long current_time = 0;
+    size_t next_arrival = 0;
+
+    while (next_arrival < n || !heap.empty())
+    {
+        // CPU is idle, jump straight to the next arrival
+        if (heap.empty() && current_time < pcbs[next_arrival].arrival)
+        {
+            current_time = pcbs[next_arrival].arrival;
+        }
+        while (next_arrival < n && pcbs[next_arrival].arrival <= current_time)
+        {
+            heap.push(&pcbs[next_arrival++]);
+        }
+
+        const ProcessControlBlock_t *current_process = heap.pop();
+        current_time += current_process->remaining_burst_time;
+        totals.complete(current_process->arrival, current_process->remaining_burst_time, current_time);
+    }
+
+    report<typename Policy::run_time>(totals, result);
+    return true;
+}
+
+// Tickless round robin
+// Each dispatch runs min(quantum, remaining), and once per round, when nothing can finish or arrive
+// for k whole rounds, those rounds are applied to every queued process at once
+template <class Policy>
+inline bool run(dyn_array_t *ready_queue, ScheduleResult_t *result, size_t quantum, time_sliced_tag)
+{
+    if (!sort_ready_queue<ByArrival>(ready_queue))
+    {
+        return false;
+    }
+    const size_t n = dyn_array_size(ready_queue);
+    ProcessControlBlock_t *pcbs = static_cast<ProcessControlBlock_t *>(dyn_array_at(ready_queue, 0));
+
+    std::vector<uint32_t> bursts(n);
+    for (size_t i = 0; i < n; ++i)
+    {
+        bursts[i] = pcbs[i].remaining_burst_time;
+    }
+
+    // FIFO of arrived processes as a ring, it never holds more than every process at once
+    // (a ring dyn_array works too, but its per-call checks make round robin about 1.7x slower)
+    std::vector<ProcessControlBlock_t *> fifo(n);
+    size_t fifo_head = 0;
+    size_t fifo_count = 0;
+
+    Totals totals;
+    unsigned long current_time = 0;
+    size_t next_arrival = 0;
+    // dispatches left before the current round is over
+    size_t round_left = 0;
+
+    while (next_arrival < n || fifo_count)
+    {
+        // If CPU is idle, move to the next arrival time
+        if (fifo_count == 0 && current_time < pcbs[next_arrival].arrival)
+        {
+            current_time = pcbs[next_arrival].arrival;
+        }
+        while (next_arrival < n && pcbs[next_arrival].arrival <= current_time)
+        {
+            fifo[(fifo_head + fifo_count++) % n] = &pcbs[next_arrival++];
+        }
+
+        // At the start of each round see how many whole rounds can pass with nothing finishing or arriving
+        if (round_left == 0)
+        {
+            round_left = fifo_count;
+            uint32_t min_remaining = UINT32_MAX;
+            for (size_t i = 0; i < fifo_count; ++i)
+            {
+                const ProcessControlBlock_t *pcb = fifo[(fifo_head + i) % n];
+                min_remaining = pcb->remaining_burst_time < min_remaining ? pcb->remaining_burst_time : min_remaining;
+            }
+            unsigned long rounds = min_remaining ? (min_remaining - 1) / quantum : 0;
+            if (rounds && next_arrival < n)
+            {
+                unsigned long until_arrival = (pcbs[next_arrival].arrival - current_time - 1) / (fifo_count * quantum);
+                rounds = rounds < until_arrival ? rounds : until_arrival;
+            }
+            if (rounds)
+            {
+                // every process runs rounds * quantum and the queue order is unchanged
+                for (size_t i = 0; i < fifo_count; ++i)
+                {
+                    ProcessControlBlock_t *pcb = fifo[(fifo_head + i) % n];
+                    pcb->remaining_burst_time -= rounds * quantum;
+                    pcb->started = true;
+                }
+                current_time += rounds * quantum * fifo_count;
+            }
+        }
+
+        // Dispatch the front process for one slice
+        ProcessControlBlock_t *current_process = fifo[fifo_head];
+        fifo_head = fifo_head + 1 == n ? 0 : fifo_head + 1;
+        --fifo_count;
+        --round_left;
+
+        unsigned long slice = current_process->remaining_burst_time < quantum ? current_process->remaining_burst_time : quantum;
+        current_process->started = true;
+        current_process->remaining_burst_time -= slice;
+        current_time += slice;
+
+        // Processes that arrived during the slice queue ahead of the preempted one
+        while (next_arrival < n && pcbs[next_arrival].arrival <= current_time)
+        {
+            fifo[(fifo_head + fifo_count++) % n] = &pcbs[next_arrival++];
+        }
+
+        if (current_process->remaining_burst_time == 0)
+        {
+            totals.complete(current_process->arrival, bursts[current_process - pcbs], current_time);
+        }
+        else
+        {
+            fifo[(fifo_head + fifo_count++) % n] = current_process;
+        }
+    }
+
+    report<typename Policy::run_time>(totals, result);
+    return true;
+}
+
+// effective priority after waited time units in the ready queue, one level better per interval, 0 is the best
+inline unsigned long aged_priority(uint32_t priority, unsigned long waited, unsigned long interval)
+{
+    unsigned long levels = interval ? waited / interval : 0;
+    return levels >= priority ? 0 : priority - levels;
+}
+
+// heap key of a process waiting since anchor, the smaller key has the better effective priority at any time
+inline unsigned long aging_key(uint32_t priority, unsigned long anchor, unsigned long interval)
+{
+    return interval ? priority * interval + anchor : priority;
+}
+
+// A ready process in the aging heap
+struct AgingEntry
+{
+    unsigned long key;  // priority * interval + anchor (just priority without aging)
+    size_t index;       // position in arrival order, breaks ties
+    bool operator>(const AgingEntry &other) const { return key != other.key ? key > other.key : index > other.index; }
+};
+
+// Event driven preemptive priority with aging
+// A process's effective priority is aged_priority of all the time it has spent waiting so far.
+// Give every waiting process an anchor, when it would have started waiting had it done all of its waiting
+// in one go. Its effective priority at t is then max(0, ceil((priority * interval + anchor - t) / interval)),
+// which only depends on priority * interval + anchor, so waiting never reorders the heap and nothing is rekeyed.
+// Aging only adds one kind of event, the computable time the heap's top ages past the running process.
+// Preempting takes a whole level and the running process doesn't age, so two processes can trade the CPU
+// at most about once per interval: O((n + time / interval) log n), never a tick at a time.
+template <class Policy>
+inline bool run(dyn_array_t *ready_queue, ScheduleResult_t *result, size_t aging_interval, aging_tag)
+{
+    if (!sort_ready_queue<ByArrival>(ready_queue))
+    {
+        return false;
+    }
+    ProcessControlBlock_t *pcbs = static_cast<ProcessControlBlock_t *>(dyn_array_at(ready_queue, 0));
+    const size_t n = dyn_array_size(ready_queue);
+    const unsigned long interval = aging_interval;
+
+    std::vector<uint32_t> bursts(n);
+    for (size_t i = 0; i < n; ++i)
+    {
+        bursts[i] = pcbs[i].remaining_burst_time;
+    }
+    std::vector<unsigned long> anchors(n);
+    std::priority_queue<AgingEntry, std::vector<AgingEntry>, std::greater<AgingEntry> > heap;
+
+    Totals totals;
+    unsigned long current_time = 0;
+    size_t next_arrival = 0;
+    size_t running = n;  // n while the CPU is idle
+    unsigned long running_priority = 0;
+    unsigned long dispatched_at = 0;
+
+    while (next_arrival < n || running < n || !heap.empty())
+    {
+        if (running == n)
+        {
+            // CPU is idle, jump straight to the next arrival
+            if (heap.empty() && current_time < pcbs[next_arrival].arrival)
+            {
+                current_time = pcbs[next_arrival].arrival;
+            }
+            for (; next_arrival < n && pcbs[next_arrival].arrival <= current_time; ++next_arrival)
+            {
+                anchors[next_arrival] = pcbs[next_arrival].arrival;
+                AgingEntry entry = {aging_key(pcbs[next_arrival].priority, anchors[next_arrival], interval), next_arrival};
+                heap.push(entry);
+            }
+            running = heap.top().index;
+            heap.pop();
+            running_priority = aged_priority(pcbs[running].priority, current_time - anchors[running], interval);
+            dispatched_at = current_time;
+            pcbs[running].started = true;
+        }
+
+        // Run until it finishes, the next arrival, or the top of the heap ages past it
+        unsigned long until = current_time + pcbs[running].remaining_burst_time;
+        if (next_arrival < n && pcbs[next_arrival].arrival < until)
+        {
+            until = pcbs[next_arrival].arrival;
+        }
+        if (interval && running_priority && !heap.empty())
+        {
+            // the top was no better at dispatch, so it needs priority + 1 - running_priority levels of waiting
+            const size_t top = heap.top().index;
+            unsigned long aged = anchors[top] + interval * (pcbs[top].priority + 1 - running_priority);
+            aged = aged > current_time ? aged : current_time;
+            until = aged < until ? aged : until;
+        }
+        pcbs[running].remaining_burst_time -= until - current_time;
+        current_time = until;
+
+        for (; next_arrival < n && pcbs[next_arrival].arrival <= current_time; ++next_arrival)
+        {
+            anchors[next_arrival] = pcbs[next_arrival].arrival;
+            AgingEntry entry = {aging_key(pcbs[next_arrival].priority, anchors[next_arrival], interval), next_arrival};
+            heap.push(entry);
+        }
+
+        if (pcbs[running].remaining_burst_time == 0)
+        {
+            totals.complete(pcbs[running].arrival, bursts[running], current_time);
+            running = n;
+        }
+        else if (!heap.empty()
+                 && aged_priority(pcbs[heap.top().index].priority, current_time - anchors[heap.top().index], interval)
+                        < running_priority)
+        {
+            // Preemption point, the running process picks its waiting back up where it left off
+            anchors[running] += current_time - dispatched_at;
+            AgingEntry entry = {aging_key(pcbs[running].priority, anchors[running], interval), running};
+            heap.push(entry);
+            running = heap.top().index;
+            heap.pop();
+            running_priority = aged_priority(pcbs[running].priority, current_time - anchors[running], interval);
+            dispatched_at = current_time;
+            pcbs[running].started = true;
+        }
+    }
+
+    report<typename Policy::run_time>(totals, result);
+    return true;
+}
+
+// One FIFO per level, linked through the positions of the processes in arrival order, so pushing at
+// either end, popping and moving a whole level are O(1). Bit l of nonempty_ is set while level l has a process,
+// the best level with work is its lowest set bit.
+// end of a level's list
+const size_t no_process = (size_t)-1;
+
+class FeedbackLevels
+{
+  public:
+    FeedbackLevels(size_t levels, size_t n) : next_(n, no_process), levels_(levels), nonempty_(0)
+    {
+        for (size_t level = 0; level < levels; ++level)
+        {
+            head_[level] = tail_[level] = no_process;
+        }
+    }
+
+    bool empty() const { return nonempty_ == 0; }
+
+    // the best level with a process waiting, only while !empty()
+    size_t best() const { return (size_t)__builtin_ctzll(nonempty_); }
+
+    void push_back(size_t level, size_t index)
+    {
+        next_[index] = no_process;
+        if (head_[level] == no_process)
+        {
+            head_[level] = index;
+            nonempty_ |= 1ULL << level;
+        }
+        else
+        {
+            next_[tail_[level]] = index;
+        }
+        tail_[level] = index;
+    }
+
+    void push_front(size_t level, size_t index)
+    {
+        next_[index] = head_[level];
+        if (head_[level] == no_process)
+        {
+            tail_[level] = index;
+            nonempty_ |= 1ULL << level;
+        }
+        head_[level] = index;
+    }
+
+    size_t pop_front(size_t level)
+    {
+        size_t index = head_[level];
+        head_[level] = next_[index];
+        if (head_[level] == no_process)
+        {
+            tail_[level] = no_process;
+            nonempty_ &= ~(1ULL << level);
+        }
+        return index;
+    }
+
+    // appends every other level, best first, to level 0
+    void merge_into_top()
+    {
+        for (size_t level = 1; level < levels_; ++level)
+        {
+            if (head_[level] == no_process)
+            {
+                continue;
+            }
+            if (head_[0] == no_process)
+            {
+                head_[0] = head_[level];
+            }
+            else
+            {
+                next_[tail_[0]] = head_[level];
+            }
+            tail_[0] = tail_[level];
+            head_[level] = tail_[level] = no_process;
+        }
+        nonempty_ = nonempty_ ? 1 : 0;
+    }
+
+  private:
+    std::vector<size_t> next_;
+    size_t head_[MLFQ_MAX_LEVELS];
+    size_t tail_[MLFQ_MAX_LEVELS];
+    size_t levels_;
+    uint64_t nonempty_;
+};
+
+// Where a process stands on its level
+struct FeedbackState
+{
+    unsigned long used;   // of its level's quantum
+    unsigned long epoch;  // boosts that had happened when used was last right
+};
+
+// Event driven multi-level feedback queue
+// A dispatch runs until the process finishes, uses up the rest of its level's quantum, a boost,
+// or an arrival when it is below level 0 (an arrival at level 0 waits its turn like in round robin).
+// A process alone on the CPU runs through as many quanta as it can in one dispatch, demoted a level
+// per quantum. A boost moves whole levels and bumps an epoch, processes forget the quantum they used
+// on their old level lazily, the next time they are dispatched.
+template <class Policy>
+inline bool run(dyn_array_t *ready_queue, ScheduleResult_t *result, const MlfqConfig_t *config, feedback_queue_tag)
+{
+    if (!sort_ready_queue<ByArrival>(ready_queue))
+    {
+        return false;
+    }
+    ProcessControlBlock_t *pcbs = static_cast<ProcessControlBlock_t *>(dyn_array_at(ready_queue, 0));
+    const size_t n = dyn_array_size(ready_queue);
+    const size_t *quanta = config->quanta;
+    const size_t last = config->levels - 1;
+    const unsigned long boost_interval = config->boost_interval;
+
+    std::vector<uint32_t> bursts(n);
+    for (size_t i = 0; i < n; ++i)
+    {
+        bursts[i] = pcbs[i].remaining_burst_time;
+    }
+    std::vector<FeedbackState> states(n);
+    FeedbackLevels levels(config->levels, n);
+
+    Totals totals;
+    unsigned long current_time = 0;
+    unsigned long next_boost = boost_interval;  // 0 never
+    unsigned long epoch = 0;
+    size_t next_arrival = 0;
+
+    while (next_arrival < n || !levels.empty())
+    {
+        // CPU is idle, jump straight to the next arrival, boosts in between have nothing to move
+        if (levels.empty() && current_time < pcbs[next_arrival].arrival)
+        {
+            current_time = pcbs[next_arrival].arrival;
+            if (boost_interval && next_boost <= current_time)
+            {
+                next_boost = (current_time / boost_interval + 1) * boost_interval;
+            }
+        }
+        for (; next_arrival < n && pcbs[next_arrival].arrival <= current_time; ++next_arrival)
+        {
+            FeedbackState arrived = {0, epoch};
+            states[next_arrival] = arrived;
+            levels.push_back(0, next_arrival);
+        }
+
+        size_t level = levels.best();
+        const size_t running = levels.pop_front(level);
+        ProcessControlBlock_t *current_process = &pcbs[running];
+        FeedbackState &state = states[running];
+        if (state.epoch != epoch)
+        {
+            state.used = 0;
+            state.epoch = epoch;
+        }
+        current_process->started = true;
+
+        unsigned long until = current_time + current_process->remaining_burst_time;
+        const bool alone = levels.empty();
+        if (!alone)
+        {
+            unsigned long slice_end = current_time + quanta[level] - state.used;
+            until = slice_end < until ? slice_end : until;
+        }
+        // alone it may sink below level 0 before the arrival, the next dispatch sorts that out
+        if (next_arrival < n && (alone || level > 0) && pcbs[next_arrival].arrival < until)
+        {
+            until = pcbs[next_arrival].arrival;
+        }
+        if (boost_interval && next_boost < until)
+        {
+            until = next_boost;
+        }
+
+        // the time counts against each level's quantum in turn
+        current_process->remaining_burst_time -= until - current_time;
+        state.used += until - current_time;
+        current_time = until;
+        while (state.used >= quanta[level])
+        {
+            if (level == last)
+            {
+                state.used %= quanta[level];
+                break;
+            }
+            state.used -= quanta[level++];
+        }
+
+        // Processes that arrived during the slice queue ahead of the demoted one
+        for (; next_arrival < n && pcbs[next_arrival].arrival <= current_time; ++next_arrival)
+        {
+            FeedbackState arrived = {0, epoch};
+            states[next_arrival] = arrived;
+            levels.push_back(0, next_arrival);
+        }
+
+        if (current_process->remaining_burst_time == 0)
+        {
+            totals.complete(current_process->arrival, bursts[running], current_time);
+        }
+        else if (state.used == 0)
+        {
+            // used up its quantum, to the back of the level it landed on
+            levels.push_back(level, running);
+        }
+        else
+        {
+            // cut short, it resumes first on its level
+            levels.push_front(level, running);
+        }
+
+        if (boost_interval && current_time == next_boost)
+        {
+            levels.merge_into_top();
+            ++epoch;
+            next_boost += boost_interval;
+        }
+    }
+
+    report<typename Policy::run_time>(totals, result);
+    return true;
+}
+
+// The multi-core engine's parameter
+struct MultiCoreRun
+{
+    const MultiCoreConfig_t *config;
+    float *utilization;  // config->cores entries, NULL when not wanted
+};
+
+// A busy core and when it finishes its process
+struct CoreEvent
+{
+    unsigned long time;
+    size_t core;
+    bool operator>(const CoreEvent &other) const { return time != other.time ? time > other.time : core > other.core; }
+};
+
+// Core numbers with O(1) insert, erase and pick by position
+class CoreSet
+{
+  public:
+    explicit CoreSet(size_t cores) : position_(cores, no_process) {}
+
+    bool empty() const { return members_.empty(); }
+    size_t size() const { return members_.size(); }
+    size_t operator[](size_t i) const { return members_[i]; }
+
+    void insert(size_t core)
+    {
+        if (position_[core] == no_process)
+        {
+            position_[core] = members_.size();
+            members_.push_back(core);
+        }
+    }
+
+    void erase(size_t core)
+    {
+        size_t position = position_[core];
+        if (position != no_process)
+        {
+            members_[position] = members_.back();
+            position_[members_[position]] = position;
+            members_.pop_back();
+            position_[core] = no_process;
+        }
+    }
+
+  private:
+    std::vector<size_t> members_;
+    std::vector<size_t> position_;
+};
+
+// Each core's FIFO of processes, plus the cores that have any for picking a victim:
+// all of them for a random pick, ordered by queued burst time for the most loaded
+class CoreQueues
+{
+  public:
+    CoreQueues(const ProcessControlBlock_t *pcbs, const MultiCoreConfig_t *config)
+        : pcbs_(pcbs), fifos_(config->cores), work_(config->cores, 0), loaded_(config->cores), steal_(config->steal),
+          random_(config->seed)
+    {
+    }
+
+    void push(size_t core, size_t index)
+    {
+        unsigned long work = work_[core];
+        fifos_[core].push_back(index);
+        set_work(core, work, work + pcbs_[index].remaining_burst_time);
+    }
+
+    // the next process for core: the front of its own FIFO, else the back of a victim's, no_process when all are empty
+    size_t take(size_t core)
+    {
+        size_t from = core;
+        size_t index;
+        if (!fifos_[core].empty())
+        {
+            index = fifos_[core].front();
+            fifos_[core].pop_front();
+        }
+        else if (!loaded_.empty())
+        {
+            from = victim();
+            index = fifos_[from].back();
+            fifos_[from].pop_back();
+        }
+        else
+        {
+            return no_process;
+        }
+        unsigned long work = work_[from];
+        set_work(from, work, work - pcbs_[index].remaining_burst_time);
+        return index;
+    }
+
+  private:
+    void set_work(size_t core, unsigned long old_work, unsigned long work)
+    {
+        work_[core] = work;
+        if (steal_ == STEAL_MOST_LOADED)
+        {
+            by_work_.erase(std::make_pair(old_work, core));
+            if (!fifos_[core].empty())
+            {
+                by_work_.insert(std::make_pair(work, core));
+            }
+        }
+        if (fifos_[core].empty())
+        {
+            loaded_.erase(core);
+        }
+        else
+        {
+            loaded_.insert(core);
+        }
+    }
+
+    size_t victim()
+    {
+        if (steal_ == STEAL_MOST_LOADED)
+        {
+            return by_work_.rbegin()->second;
+        }
+        // splitmix64
+        uint64_t z = (random_ += 0x9E3779B97F4A7C15ULL);
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+        return loaded_[(z ^ (z >> 31)) % loaded_.size()];
+    }
+
+    const ProcessControlBlock_t *pcbs_;
+    std::vector<std::deque<size_t> > fifos_;
+    std::vector<unsigned long> work_;  // queued burst time of each core
+    CoreSet loaded_;                   // cores with a queued process
+    std::set<std::pair<unsigned long, size_t> > by_work_;  // (work, core) of loaded_, for STEAL_MOST_LOADED only
+    StealPolicy_t steal_;
+    uint64_t random_;
+};
+
+// Event driven cores
+// The only events are arrivals, in order, and cores finishing, from a heap of finish times, so a run is
+// O(n log cores). An idle core always steals whatever there is, so idle cores only exist while every FIFO
+// is empty and an arrival on a busy core goes straight to the lowest numbered idle one.
+// Completions at the same time as an arrival go first, so the freed cores can take it.
+template <class Policy>
+inline bool run(dyn_array_t *ready_queue, ScheduleResult_t *result, const MultiCoreRun &parameter, multi_core_tag)
+{
+    if (!sort_ready_queue<ByArrival>(ready_queue))
+    {
+        return false;
+    }
+    const ProcessControlBlock_t *pcbs = static_cast<const ProcessControlBlock_t *>(dyn_array_at(ready_queue, 0));
+    const size_t n = dyn_array_size(ready_queue);
+    const size_t cores = parameter.config->cores;
+
+    CoreQueues queues(pcbs, parameter.config);
+    std::set<size_t> idle;
+    for (size_t core = 0; core < cores; ++core)
+    {
+        idle.insert(idle.end(), core);
+    }
+    std::vector<unsigned long> busy_time(cores, 0);
+    std::priority_queue<CoreEvent, std::vector<CoreEvent>, std::greater<CoreEvent> > events;
+    Totals totals;
+    size_t next_arrival = 0;
+
+    while (next_arrival < n || !events.empty())
+    {
+        size_t core;
+        unsigned long current_time;
+        if (!events.empty() && (next_arrival == n || events.top().time <= pcbs[next_arrival].arrival))
+        {
+            core = events.top().core;
+            current_time = events.top().time;
+            events.pop();
+        }
+        else
+        {
+            current_time = pcbs[next_arrival].arrival;
+            const size_t home = next_arrival % cores;
+            queues.push(home, next_arrival++);
+            if (idle.empty())
+            {
+                continue;
+            }
+            core = idle.count(home) ? home : *idle.begin();
+            idle.erase(core);
+        }
+
+        // the core is free, it runs its next process to completion or goes idle
+        const size_t index = queues.take(core);
+        if (index == no_process)
+        {
+            idle.insert(core);
+            continue;
+        }
+        const uint32_t burst = pcbs[index].remaining_burst_time;
+        totals.complete(pcbs[index].arrival, burst, current_time + burst);
+        busy_time[core] += burst;
+        CoreEvent finish = {current_time + burst, core};
+        events.push(finish);
+    }
+
+    report<typename Policy::run_time>(totals, result);
+    if (parameter.utilization)
+    {
+        const unsigned long span = Policy::run_time::report(totals);
+        for (size_t core = 0; core < cores; ++core)
+        {
+            parameter.utilization[core] = span ? (float)busy_time[core] / span : 0.0f;
+        }
+    }
+    return true;
+}
+
+// Weight of each nice level from -20 to 19 as Linux has them, a level is about 10% of CPU time
+static const uint32_t fair_weights[40] = {
+    88761, 71755, 56483, 46273, 36291, 29154, 23254, 18705, 14949, 11916, 9548, 7620, 6100, 4904,
+    3906,  3121,  2501,  1991,  1586,  1277,  1024,  820,   655,   526,   423,  335,  272,  215,
+    172,   137,   110,   87,    70,    56,    45,    36,    29,    23,    18,    15,
+};
+
+// priority 0 weighs like nice -20, 20 like nice 0, 39 and above like nice 19
+inline uint32_t fair_weight(uint32_t priority)
+{
+    return fair_weights[priority < 39 ? priority : 39];
+}
+
+// virtual time of exec units of CPU time at weight, 1024 per unit at nice 0
+inline uint64_t fair_virtual_time(uint64_t exec, uint32_t weight)
+{
+    return (exec << 20) / weight;
+}
+
+// Event driven completely fair scheduling
+// The runnable processes live in a red-black tree (std::set) keyed by (vruntime, arrival position), which keeps
+// its leftmost node, so picking the next process is O(1) and putting one back O(log n). A process's vruntime
+// is where it was placed plus the virtual time of all the CPU time it has had, never a running sum of rounded
+// slices, so how a run is cut into dispatches doesn't change it. A process alone on the CPU runs through slice
+// after slice in one dispatch until the slice an arrival lands in is over.
+template <class Policy>
+inline bool run(dyn_array_t *ready_queue, ScheduleResult_t *result, const CfsConfig_t *config, fair_tag)
+{
+    if (!sort_ready_queue<ByArrival>(ready_queue))
+    {
+        return false;
+    }
+    ProcessControlBlock_t *pcbs = static_cast<ProcessControlBlock_t *>(dyn_array_at(ready_queue, 0));
+    const size_t n = dyn_array_size(ready_queue);
+    const uint64_t latency = config->target_latency;
+    const uint64_t granularity = config->min_granularity;
+    // more runnable processes than this stretch the period past target_latency
+    const uint64_t latency_processes = latency / granularity;
+
+    std::vector<uint32_t> bursts(n);
+    for (size_t i = 0; i < n; ++i)
+    {
+        bursts[i] = pcbs[i].remaining_burst_time;
+    }
+    std::vector<uint64_t> placed(n);  // min_vruntime when it arrived
+    std::set<std::pair<uint64_t, size_t> > timeline;
+    uint64_t queued_weight = 0;
+    uint64_t min_vruntime = 0;
+
+    Totals totals;
+    unsigned long current_time = 0;
+    size_t next_arrival = 0;
+
+    while (next_arrival < n || !timeline.empty())
+    {
+        // CPU is idle, jump straight to the next arrival
+        if (timeline.empty() && current_time < pcbs[next_arrival].arrival)
+        {
+            current_time = pcbs[next_arrival].arrival;
+        }
+        for (; next_arrival < n && pcbs[next_arrival].arrival <= current_time; ++next_arrival)
+        {
+            placed[next_arrival] = min_vruntime;
+            timeline.insert(std::make_pair(min_vruntime, next_arrival));
+            queued_weight += fair_weight(pcbs[next_arrival].priority);
+        }
+
+        // The leftmost process runs for its share of the period
+        const size_t running = timeline.begin()->second;
+        timeline.erase(timeline.begin());
+        ProcessControlBlock_t *current_process = &pcbs[running];
+        const uint32_t weight = fair_weight(current_process->priority);
+        queued_weight -= weight;
+        current_process->started = true;
+
+        const uint64_t runnable = timeline.size() + 1;
+        const uint64_t period = runnable > latency_processes ? runnable * granularity : latency;
+        uint64_t slice = period * weight / (queued_weight + weight);
+        slice = slice > granularity ? slice : granularity;
+
+        unsigned long until = current_time + current_process->remaining_burst_time;
+        if (!timeline.empty())
+        {
+            until = current_time + slice < until ? current_time + slice : until;
+        }
+        else if (next_arrival < n)
+        {
+            // alone until the slice the next arrival lands in is over
+            const uint64_t slices = (pcbs[next_arrival].arrival - current_time + slice - 1) / slice;
+            until = current_time + slices * slice < until ? current_time + slices * slice : until;
+        }
+
+        // min_vruntime follows the smallest vruntime of the running and runnable processes, never going back
+        const uint64_t start_exec = bursts[running] - current_process->remaining_burst_time;
+        for (; next_arrival < n && pcbs[next_arrival].arrival <= until; ++next_arrival)
+        {
+            uint64_t smallest =
+                placed[running] + fair_virtual_time(start_exec + pcbs[next_arrival].arrival - current_time, weight);
+            if (!timeline.empty() && timeline.begin()->first < smallest)
+            {
+                smallest = timeline.begin()->first;
+            }
+            min_vruntime = smallest > min_vruntime ? smallest : min_vruntime;
+            placed[next_arrival] = min_vruntime;
+            timeline.insert(std::make_pair(min_vruntime, next_arrival));
+            queued_weight += fair_weight(pcbs[next_arrival].priority);
+        }
+
+        current_process->remaining_burst_time -= until - current_time;
+        current_time = until;
+        const uint64_t vruntime =
+            placed[running] + fair_virtual_time(bursts[running] - current_process->remaining_burst_time, weight);
+        uint64_t smallest = timeline.empty() || vruntime < timeline.begin()->first ? vruntime : timeline.begin()->first;
+        min_vruntime = smallest > min_vruntime ? smallest : min_vruntime;
+
+        if (current_process->remaining_burst_time == 0)
+        {
+            totals.complete(current_process->arrival, bursts[running], current_time);
+        }
+        else
+        {
+            timeline.insert(std::make_pair(vruntime, running));
+            queued_weight += weight;
+        }
+    }
+
+    report<typename Policy::run_time>(totals, result);
+    return true;
+}
+
+// Runs Policy over a validated, non-empty ready queue, a dyn_array of ProcessControlBlock_t or a PcbSoA_t
+template <class Policy, class Queue, class Parameter = size_t>
+inline bool schedule(Queue *ready_queue, ScheduleResult_t *result, Parameter parameter = Parameter())
+{
+    return run<Policy>(ready_queue, result, parameter, typename Policy::engine());
+}
+
+//
+// The policies behind the C entry points
+//
+
+typedef NonPreemptivePolicy<ByArrival, RunTimeIsBusyTime, false> FirstComeFirstServe;
+typedef NonPreemptivePolicy<ByBurst, RunTimeIsBusyTime, true> ShortestJobFirst;
+typedef NonPreemptivePolicy<ByPriority, RunTimeIsMakespan, true> Priority;
+typedef TimeSlicedPolicy<RunTimeIsTurnaroundSum> RoundRobin;
+typedef PreemptivePolicy<ByBurst, RunTimeIsMakespan> ShortestRemainingTimeFirst;
+typedef AgingPolicy<RunTimeIsMakespan> PreemptivePriority;
+typedef ArrivalAwarePolicy<ByBurst, RunTimeIsMakespan> ShortestJobFirstArrivalAware;
+typedef ArrivalAwarePolicy<ByPriority, RunTimeIsMakespan> PriorityArrivalAware;
+typedef FeedbackQueuePolicy<RunTimeIsMakespan> MultiLevelFeedbackQueue;
+typedef MultiCorePolicy<RunTimeIsMakespan> MultiCoreFirstComeFirstServe;
+typedef FairPolicy<RunTimeIsMakespan> CompletelyFair;
+
+}  // namespace scheduler_engine
+
+#endif
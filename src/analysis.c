@@ -1,30 +1,354 @@
 #define _GNU_SOURCE
+#include <pthread.h>
+#include <stdatomic.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 #include <time.h>
+#include <unistd.h>
 // Include headers: dyn_array, processing_scheduling
 #include "dyn_array.h"
 #include "processing_scheduling.h"
 
+#define CFS "CFS"
 #define FCFS "FCFS"
 #define P "P"
+#define PP "PP"
 #define RR "RR"
 #define SJF "SJF"
+#define SRTF "SRTF"
+#define ALL "ALL"
+#define SWEEP "SWEEP"
 
+// CFS's target latency when no number is given, its minimum granularity is an eighth of the latency
+#define CFS_DEFAULT_LATENCY 24
+
+// one algorithm of an ALL run, each gets its own copy of the pcbs and its own thread
+typedef struct
+{
+    const char *name;
+    int alg;
+    dyn_array_t *queue;
+    size_t quantum;
+    ScheduleResult_t result;
+    bool ok;
+} analysis_job_t;
+
+// CFS settings for the number given after the algorithm, 0 takes CFS_DEFAULT_LATENCY
+static CfsConfig_t cfs_config(size_t target_latency)
+{
+    size_t latency = target_latency ? target_latency : CFS_DEFAULT_LATENCY;
+    CfsConfig_t config = {latency, latency >= 8 ? latency / 8 : 1};
+    return config;
+}
+
+// runs algorithm alg (numbered like the single algorithm mode in main)
+static bool run_algorithm(int alg, dyn_array_t *queue, ScheduleResult_t *result, size_t quantum)
+{
+    switch (alg)
+    {
+    case 0:
+        return first_come_first_serve(queue, result);
+    case 1:
+        return priority(queue, result);
+    case 2:
+        return round_robin(queue, result, quantum);
+    case 3:
+        return shortest_job_first(queue, result);
+    case 7:
+        // the number after the algorithm is RR's quantum, PP's aging interval and CFS's target latency
+        return preemptive_priority(queue, result, quantum);
+    case 8:
+    {
+        CfsConfig_t config = cfs_config(quantum);
+        return completely_fair(queue, result, &config);
+    }
+    default:
+        return shortest_remaining_time_first(queue, result);
+    }
+}
+
+// thread entry for one job
+static void *run_job(void *arg)
+{
+    analysis_job_t *job = (analysis_job_t *)arg;
+    job->ok = run_algorithm(job->alg, job->queue, &job->result, job->quantum);
+    return NULL;
+}
+
+// Runs every algorithm over one loaded set of pcbs at the same time and reports them together
+// RR only runs when a quantum was given
+static int run_all_algorithms(const dyn_array_t *pcbs, size_t quantum, const char *time_buffer)
+{
+    analysis_job_t jobs[] = {
+        {FCFS, 0, NULL, quantum, {0.0f, 0.0f, 0UL}, false},
+        {P, 1, NULL, quantum, {0.0f, 0.0f, 0UL}, false},
+        {RR, 2, NULL, quantum, {0.0f, 0.0f, 0UL}, false},
+        {SJF, 3, NULL, quantum, {0.0f, 0.0f, 0UL}, false},
+        {SRTF, 4, NULL, quantum, {0.0f, 0.0f, 0UL}, false},
+        {PP, 7, NULL, quantum, {0.0f, 0.0f, 0UL}, false},
+        {CFS, 8, NULL, quantum, {0.0f, 0.0f, 0UL}, false},
+    };
+    const size_t job_count = sizeof(jobs) / sizeof(jobs[0]);
+    pthread_t threads[sizeof(jobs) / sizeof(jobs[0])];
+    bool started[sizeof(jobs) / sizeof(jobs[0])] = {false};
+    int status = EXIT_SUCCESS;
+
+    for (size_t i = 0; i < job_count; ++i)
+    {
+        if (jobs[i].alg == 2 && quantum == 0)
+        {
+            fprintf(stderr, "%s:%d no quantum given, skipping rr\n", __FILE__, __LINE__);
+            continue;
+        }
+        // every scheduler sorts and mutates its queue, so each one works on a private copy
+        jobs[i].queue = dyn_array_import(dyn_array_export(pcbs), dyn_array_size(pcbs), dyn_array_data_size(pcbs), NULL);
+        if (!jobs[i].queue)
+        {
+            fprintf(stderr, "%s:%d failed to copy pcbs for %s\n", __FILE__, __LINE__, jobs[i].name);
+            status = EXIT_FAILURE;
+            continue;
+        }
+        started[i] = pthread_create(&threads[i], NULL, run_job, &jobs[i]) == 0;
+        if (!started[i])
+        {
+            // no thread to be had, just run it here
+            run_job(&jobs[i]);
+        }
+    }
+
+    for (size_t i = 0; i < job_count; ++i)
+    {
+        if (started[i])
+        {
+            pthread_join(threads[i], NULL);
+        }
+    }
+
+    // Open the README.md file for appending results
+    FILE *pFile = fopen("../README.md", "a");
+    // check if th file opens
+    if (!pFile)
+    {
+        fprintf(stderr, "%s:%d readme failed to open \n", __FILE__, __LINE__);
+        status = EXIT_FAILURE;
+    }
+    for (size_t i = 0; i < job_count; ++i)
+    {
+        if (!jobs[i].queue)
+        {
+            continue;
+        }
+        dyn_array_destroy(jobs[i].queue);
+        if (!jobs[i].ok)
+        {
+            fprintf(stderr, "%s:%d failed %s\n", __FILE__, __LINE__, jobs[i].name);
+            status = EXIT_FAILURE;
+            continue;
+        }
+        printf("%-5s wait %10.2f  turnaround %10.2f  run time %lu\n", jobs[i].name, jobs[i].result.average_waiting_time,
+               jobs[i].result.average_turnaround_time, jobs[i].result.total_run_time);
+        if (pFile)
+        {
+            // Write results to README.md
+            fprintf(pFile, "---------%s %s-----------\n", time_buffer, jobs[i].name);
+            fprintf(pFile, "Average wait time: %.2f\n", jobs[i].result.average_waiting_time);
+            fprintf(pFile, "Average turnaround time: %.2f\n", jobs[i].result.average_turnaround_time);
+            fprintf(pFile, "Total run time: %lu\n", jobs[i].result.total_run_time);
+            fprintf(pFile, "---------------------------------------\n");
+        }
+    }
+    if (pFile)
+    {
+        fclose(pFile);
+    }
+    return status;
+}
+
+
+// shared state of a round robin quantum sweep, workers claim quanta through next
+typedef struct
+{
+    const dyn_array_t *pcbs;
+    const size_t *quanta;
+    ScheduleResult_t *results;
+    bool *ok;
+    size_t count;
+    atomic_size_t next;
+} quantum_sweep_t;
+
+// Parses a quantum list like "1..100" or "1,2,4,8" or "1..10,20,50" into a new array
+// \return the quanta (free it) and their count in count, NULL on bad input
+static size_t *parse_quanta(const char *spec, size_t *count)
+{
+    size_t capacity = 16;
+    size_t *quanta = (size_t *)malloc(sizeof(size_t) * capacity);
+    *count = 0;
+    while (quanta && *spec)
+    {
+        size_t first, last;
+        int used = 0;
+        if (sscanf(spec, "%zu..%zu%n", &first, &last, &used) != 2)
+        {
+            if (sscanf(spec, "%zu%n", &first, &used) != 1)
+            {
+                break;
+            }
+            last = first;
+        }
+        // a zero quantum or a backwards range fails the whole list (spec stays where it is)
+        if (first == 0 || first > last)
+        {
+            break;
+        }
+        spec += used;
+        for (size_t q = first;; ++q)
+        {
+            if (*count == capacity)
+            {
+                capacity <<= 1;
+                size_t *grown = (size_t *)realloc(quanta, sizeof(size_t) * capacity);
+                if (!grown)
+                {
+                    free(quanta);
+                    return NULL;
+                }
+                quanta = grown;
+            }
+            quanta[(*count)++] = q;
+            // stops on last itself so a range ending at SIZE_MAX can't wrap around
+            if (q == last)
+            {
+                break;
+            }
+        }
+        if (*spec == ',')
+        {
+            ++spec;
+        }
+        else if (*spec)
+        {
+            break;
+        }
+    }
+    if (quanta && (*spec || *count == 0))
+    {
+        free(quanta);
+        return NULL;
+    }
+    return quanta;
+}
+
+// sweep worker, keeps claiming the next quantum until there are none left
+static void *sweep_worker(void *arg)
+{
+    quantum_sweep_t *sweep = (quantum_sweep_t *)arg;
+    for (size_t i = atomic_fetch_add(&sweep->next, 1); i < sweep->count; i = atomic_fetch_add(&sweep->next, 1))
+    {
+        // round robin mutates its queue, every quantum gets a fresh copy
+        dyn_array_t *queue = dyn_array_import(dyn_array_export(sweep->pcbs), dyn_array_size(sweep->pcbs),
+                                              dyn_array_data_size(sweep->pcbs), NULL);
+        sweep->ok[i] = queue && round_robin(queue, &sweep->results[i], sweep->quanta[i]);
+        dyn_array_destroy(queue);
+    }
+    return NULL;
+}
+
+// Runs round robin for every quantum in spec over one loaded set of pcbs on every core and prints a table
+static int run_quantum_sweep(dyn_array_t *pcbs, const char *spec)
+{
+    size_t count;
+    size_t *quanta = parse_quanta(spec, &count);
+    if (!quanta)
+    {
+        fprintf(stderr, "Invalid quantum list: %s\n", spec);
+        return EXIT_FAILURE;
+    }
+
+    // sort once so every copy starts out in arrival order
+    dyn_array_sort_by_u32_key(pcbs, offsetof(ProcessControlBlock_t, arrival), DYN_NO_TIEBREAK);
+
+    quantum_sweep_t sweep = {pcbs, quanta, (ScheduleResult_t *)calloc(count, sizeof(ScheduleResult_t)),
+                             (bool *)calloc(count, sizeof(bool)), count, 0};
+    long cores = sysconf(_SC_NPROCESSORS_ONLN);
+    size_t thread_count = cores > 0 ? (size_t)cores : 1;
+    thread_count = thread_count < count ? thread_count : count;
+    pthread_t *threads = (pthread_t *)malloc(sizeof(pthread_t) * thread_count);
+    if (!sweep.results || !sweep.ok || !threads)
+    {
+        fprintf(stderr, "%s:%d failed sweep malloc\n", __FILE__, __LINE__);
+        free(threads);
+        free(sweep.ok);
+        free(sweep.results);
+        free(quanta);
+        return EXIT_FAILURE;
+    }
+
+    size_t started = 0;
+    while (started < thread_count && pthread_create(&threads[started], NULL, sweep_worker, &sweep) == 0)
+    {
+        ++started;
+    }
+    if (started == 0)
+    {
+        // no threads to be had, sweep right here
+        sweep_worker(&sweep);
+    }
+    for (size_t i = 0; i < started; ++i)
+    {
+        pthread_join(threads[i], NULL);
+    }
+
+    int status = EXIT_SUCCESS;
+    printf("%10s %14s %16s %16s\n", "quantum", "avg wait", "avg turnaround", "total run time");
+    for (size_t i = 0; i < count; ++i)
+    {
+        if (!sweep.ok[i])
+        {
+            fprintf(stderr, "%s:%d failed round robin with quantum %zu\n", __FILE__, __LINE__, quanta[i]);
+            status = EXIT_FAILURE;
+            continue;
+        }
+        printf("%10zu %14.2f %16.2f %16lu\n", quanta[i], sweep.results[i].average_waiting_time,
+               sweep.results[i].average_turnaround_time, sweep.results[i].total_run_time);
+    }
+
+    free(threads);
+    free(sweep.ok);
+    free(sweep.results);
+    free(quanta);
+    return status;
+}
 
 int main(int argc, char **argv) 
 {
     // check arg count
     if (argc < 3) 
     {
-        printf("%s <pcb file> <schedule algorithm> [quantum]\n", argv[0]);
+        printf("%s <pcb file> <schedule algorithm> [quantum, or aging interval for PP, or target latency for CFS]\n", argv[0]);
         return EXIT_FAILURE;
     }
     int alg;
-    if(strncmp(argv[2],FCFS,4)==0){
+    if(strncmp(argv[2],SWEEP,5)==0){
+        if (argc < 4)
+        {
+            printf("%s <pcb file> SWEEP <quanta, e.g. 1..100 or 1,2,4,8>\n", argv[0]);
+            return EXIT_FAILURE;
+        }
+        alg = 6;
+    }
+    else if(strncmp(argv[2],ALL,3)==0){
+        alg = 5;
+    }
+    else if(strncmp(argv[2],FCFS,4)==0){
         alg = 0;
     }
+    else if(strncmp(argv[2],CFS,3)==0){
+        alg = 8;
+    }
+    else if(strncmp(argv[2],PP,2)==0){
+        alg = 7;
+    }
     else if(strncmp(argv[2],P,1)==0){
         alg = 1;
     }
@@ -37,8 +361,8 @@ int main(int argc, char **argv)
 	else{
 		alg = 4;
 	}
-    size_t quanta;
-	if(argv[3] != NULL){
+    size_t quanta = 0;
+	if(argv[3] != NULL && alg != 6){
 		if (sscanf(argv[3], "%zu", &quanta) != 1) {
 			fprintf(stderr, "Invalid quanta: %s\n", argv[3]);
 			return EXIT_FAILURE;
@@ -55,8 +379,10 @@ int main(int argc, char **argv)
     strftime(time_buffer, sizeof(time_buffer), "%Y-%m-%d %H:%M:%S", timeinfo);
     
 
+    // "-" reads the pcbs from stdin so a generator can be piped in
+    bool from_stdin = strcmp(argv[1], "-") == 0;
     //takes file name and adds space for ../ and \n opperatort to read
-    size_t file_name_length = strnlen(argv[1],20) + 3 + 1;
+    size_t file_name_length = strlen(argv[1]) + 3 + 1;
     // create the space for the file
     char * file_name = malloc(file_name_length);
     //check for failed file allocation
@@ -65,7 +391,7 @@ int main(int argc, char **argv)
         return EXIT_FAILURE;
     }
     // concatinate the file name 
-    snprintf(file_name,file_name_length,"../%s",argv[1]);
+    snprintf(file_name,file_name_length,from_stdin || argv[1][0] == '/' ? "%s" : "../%s",argv[1]);
     // Allocate memory for FCFS scheduler results
     ScheduleResult_t *Result = (ScheduleResult_t *)malloc(sizeof(ScheduleResult_t));
     //check for failed allocation
@@ -74,16 +400,61 @@ int main(int argc, char **argv)
         fprintf(stderr, "%s:%d failed fcfs result malloc fail\n", __FILE__, __LINE__);
         return EXIT_FAILURE;
     }
-    // Load the process control blocks from the binary file
-    dyn_array_t *binArray = load_process_control_blocks(file_name);
-    // check if binary file allocation failed
-    if (!binArray) 
+    // FCFS on stdin never holds more than one chunk of the input, everything else loads it all
+    bool stream_fcfs = from_stdin && alg == 0;
+    dyn_array_t *binArray = NULL;
+    if (!stream_fcfs)
+    {
+        // Load the process control blocks from the binary file
+        binArray = load_process_control_blocks(file_name);
+        // check if binary file allocation failed
+        if (!binArray) 
+        {
+            fprintf(stderr, "%s:%d failed first come first serve\n", __FILE__, __LINE__);
+            free(Result);
+            return EXIT_FAILURE;
+        }
+    }
+    if (alg == 6)
     {
-        fprintf(stderr, "%s:%d failed first come first serve\n", __FILE__, __LINE__);
+        // SWEEP loads once and runs every quantum side by side
+        int status = run_quantum_sweep(binArray, argv[3]);
+        dyn_array_destroy(binArray);
         free(Result);
-        return EXIT_FAILURE;
+        free(file_name);
+        return status;
+    }
+    if (alg == 5)
+    {
+        // ALL loads once and runs everything side by side
+        int status = run_all_algorithms(binArray, quanta, time_buffer);
+        dyn_array_destroy(binArray);
+        free(Result);
+        free(file_name);
+        return status;
+    }
+    if (stream_fcfs)
+    {
+        PcbStream_t *stream = (PcbStream_t *)malloc(sizeof(PcbStream_t));
+        bool streamed = stream && open_process_control_stream(file_name, stream);
+        if (streamed)
+        {
+            streamed = first_come_first_serve_stream(stream, Result);
+            close_process_control_stream(stream);
+        }
+        free(stream);
+        if (streamed)
+        {
+            fprintf(stderr, "%s:%d passed fcfs stream \n", __FILE__, __LINE__);
+        }
+        else
+        {
+            fprintf(stderr, "%s:%d failed streaming first come first serve\n", __FILE__, __LINE__);
+            free(Result);
+            return EXIT_FAILURE;
+        }
     }
-    if(alg == 0){
+    else if(alg == 0){
         // Perform the FCFS scheduling
         
         // Check if the scheduling was successful
@@ -136,6 +507,33 @@ int main(int argc, char **argv)
             free(Result);
             return EXIT_FAILURE;
         }
+    }
+    else if(alg == 7){
+        if (preemptive_priority(binArray, Result, quanta))
+        {
+            fprintf(stderr, "%s:%d passed preemptive priority \n", __FILE__, __LINE__);
+        }
+        else
+        {
+            fprintf(stderr, "%s:%d failed preemptive priority\n", __FILE__, __LINE__);
+            dyn_array_destroy(binArray);
+            free(Result);
+            return EXIT_FAILURE;
+        }
+    }
+    else if(alg == 8){
+        CfsConfig_t config = cfs_config(quanta);
+        if (completely_fair(binArray, Result, &config))
+        {
+            fprintf(stderr, "%s:%d passed completely fair \n", __FILE__, __LINE__);
+        }
+        else
+        {
+            fprintf(stderr, "%s:%d failed completely fair\n", __FILE__, __LINE__);
+            dyn_array_destroy(binArray);
+            free(Result);
+            return EXIT_FAILURE;
+        }
     }
 	else{
 		if (shortest_remaining_time_first(binArray, Result)) 
@@ -0,0 +1,385 @@
+#include <atomic>
+#include <system_error>
+#include <thread>
+#include <vector>
+
+#include "scheduler_engine.hpp"
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define COMPLETION_KERNEL_X86 1
+#endif
+
+// Completion-time kernels for the non-preemptive schedulers
+//
+// With E_k the bursts before pcb k in a block and cur the time the CPU is free when the block starts:
+//   idle jumps:  start_k = E_k + max(cur, max_{j<=k}(arrival_j - E_j))     (a max-plus prefix scan)
+//   FCFS:        start_k = max(cur + E_k, arrival_k)
+// and wait_k = start_k - arrival_k either way. Both scans run in 64 bit lanes since the running times
+// outgrow uint32, so that is 4 lanes with AVX2 and 2 with SSE4.2.
+
+namespace scheduler_engine
+{
+
+void completion_kernel_scalar(const uint32_t *burst_time, const uint32_t *arrival, size_t n, size_t stride,
+                              bool idle_jumps_to_arrival, CompletionState *state)
+{
+    unsigned long current_time = state->current_time;
+    unsigned long total_wait_time = state->total_wait_time;
+    unsigned long total_burst_time = state->total_burst_time;
+    unsigned long last_completion = state->last_completion;
+    for (size_t i = 0; i < n; ++i)
+    {
+        unsigned long burst = burst_time[i * stride];
+        unsigned long arrived = arrival[i * stride];
+        if (idle_jumps_to_arrival && current_time < arrived)
+        {
+            current_time = arrived;
+        }
+        // FCFS style accounting starts counting from the arrival when the CPU is behind it
+        unsigned long start = current_time >= arrived ? current_time : arrived;
+        total_wait_time += start - arrived;
+        total_burst_time += burst;
+        last_completion = start + burst > last_completion ? start + burst : last_completion;
+        current_time += burst;
+    }
+    state->current_time = current_time;
+    state->total_wait_time = total_wait_time;
+    state->total_burst_time = total_burst_time;
+    state->last_completion = last_completion;
+    state->count += n;
+}
+
+#ifdef COMPLETION_KERNEL_X86
+
+namespace
+{
+
+//
+// AVX2, 4 pcbs per block
+//
+
+__attribute__((target("avx2"))) inline __m256i max_epi64_avx2(__m256i a, __m256i b)
+{
+    return _mm256_blendv_epi8(b, a, _mm256_cmpgt_epi64(a, b));
+}
+
+// lanes moved up by one and two, the lanes left empty come from fill
+__attribute__((target("avx2"))) inline __m256i shift1_avx2(__m256i x, __m256i fill)
+{
+    return _mm256_blend_epi32(_mm256_permute4x64_epi64(x, _MM_SHUFFLE(2, 1, 0, 0)), fill, 0x03);
+}
+
+__attribute__((target("avx2"))) inline __m256i shift2_avx2(__m256i x, __m256i fill)
+{
+    return _mm256_blend_epi32(_mm256_permute4x64_epi64(x, _MM_SHUFFLE(1, 0, 0, 0)), fill, 0x0F);
+}
+
+__attribute__((target("avx2"))) inline __m256i last_lane_avx2(__m256i x)
+{
+    return _mm256_permute4x64_epi64(x, _MM_SHUFFLE(3, 3, 3, 3));
+}
+
+__attribute__((target("avx2"))) inline unsigned long sum_lanes_avx2(__m256i x)
+{
+    __m128i pair = _mm_add_epi64(_mm256_castsi256_si128(x), _mm256_extracti128_si256(x, 1));
+    return (unsigned long)(_mm_cvtsi128_si64(pair) + _mm_extract_epi64(pair, 1));
+}
+
+__attribute__((target("avx2"))) void completion_kernel_avx2_impl(const uint32_t *burst_time, const uint32_t *arrival,
+                                                                 size_t n, size_t, bool idle_jumps_to_arrival,
+                                                                 CompletionState *state)
+{
+    const __m256i zero = _mm256_setzero_si256();
+    const __m256i lowest = _mm256_set1_epi64x(INT64_MIN);
+    __m256i current = _mm256_set1_epi64x((long long)state->current_time);
+    __m256i last = _mm256_set1_epi64x((long long)state->last_completion);
+    __m256i waits = zero;
+    __m256i bursts = zero;
+
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4)
+    {
+        __m256i burst = _mm256_cvtepu32_epi64(_mm_loadu_si128((const __m128i *)(burst_time + i)));
+        __m256i arrived = _mm256_cvtepu32_epi64(_mm_loadu_si128((const __m128i *)(arrival + i)));
+        // inclusive and exclusive prefix sums of the bursts in the block
+        __m256i inclusive = _mm256_add_epi64(burst, shift1_avx2(burst, zero));
+        inclusive = _mm256_add_epi64(inclusive, shift2_avx2(inclusive, zero));
+        __m256i before = _mm256_sub_epi64(inclusive, burst);
+        __m256i start;
+        if (idle_jumps_to_arrival)
+        {
+            __m256i slack = _mm256_sub_epi64(arrived, before);
+            slack = max_epi64_avx2(slack, shift1_avx2(slack, lowest));
+            slack = max_epi64_avx2(slack, shift2_avx2(slack, lowest));
+            slack = max_epi64_avx2(slack, current);
+            start = _mm256_add_epi64(before, slack);
+            current = last_lane_avx2(_mm256_add_epi64(inclusive, slack));
+            last = current;
+        }
+        else
+        {
+            start = max_epi64_avx2(_mm256_add_epi64(current, before), arrived);
+            last = max_epi64_avx2(last, _mm256_add_epi64(start, burst));
+            current = _mm256_add_epi64(current, last_lane_avx2(inclusive));
+        }
+        waits = _mm256_add_epi64(waits, _mm256_sub_epi64(start, arrived));
+        bursts = _mm256_add_epi64(bursts, burst);
+    }
+
+    unsigned long last_lanes[4];
+    _mm256_storeu_si256((__m256i *)last_lanes, last);
+    unsigned long last_completion = last_lanes[0];
+    for (size_t lane = 1; lane < 4; ++lane)
+    {
+        last_completion = last_lanes[lane] > last_completion ? last_lanes[lane] : last_completion;
+    }
+
+    state->current_time = (unsigned long)_mm256_extract_epi64(current, 0);
+    state->total_wait_time += sum_lanes_avx2(waits);
+    state->total_burst_time += sum_lanes_avx2(bursts);
+    state->last_completion = last_completion;
+    state->count += i;
+    completion_kernel_scalar(burst_time + i, arrival + i, n - i, 1, idle_jumps_to_arrival, state);
+}
+
+//
+// SSE4.2, 2 pcbs per block
+//
+
+__attribute__((target("sse4.2"))) inline __m128i max_epi64_sse4(__m128i a, __m128i b)
+{
+    return _mm_blendv_epi8(b, a, _mm_cmpgt_epi64(a, b));
+}
+
+__attribute__((target("sse4.2"))) inline __m128i shift1_sse4(__m128i x, __m128i fill)
+{
+    return _mm_blend_epi16(_mm_slli_si128(x, 8), fill, 0x0F);
+}
+
+__attribute__((target("sse4.2"))) inline __m128i last_lane_sse4(__m128i x)
+{
+    return _mm_unpackhi_epi64(x, x);
+}
+
+__attribute__((target("sse4.2"))) void completion_kernel_sse4_impl(const uint32_t *burst_time, const uint32_t *arrival,
+                                                                   size_t n, size_t, bool idle_jumps_to_arrival,
+                                                                   CompletionState *state)
+{
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i lowest = _mm_set1_epi64x(INT64_MIN);
+    __m128i current = _mm_set1_epi64x((long long)state->current_time);
+    __m128i last = _mm_set1_epi64x((long long)state->last_completion);
+    __m128i waits = zero;
+    __m128i bursts = zero;
+
+    size_t i = 0;
+    for (; i + 2 <= n; i += 2)
+    {
+        __m128i burst = _mm_cvtepu32_epi64(_mm_loadl_epi64((const __m128i *)(burst_time + i)));
+        __m128i arrived = _mm_cvtepu32_epi64(_mm_loadl_epi64((const __m128i *)(arrival + i)));
+        __m128i inclusive = _mm_add_epi64(burst, shift1_sse4(burst, zero));
+        __m128i before = _mm_sub_epi64(inclusive, burst);
+        __m128i start;
+        if (idle_jumps_to_arrival)
+        {
+            __m128i slack = _mm_sub_epi64(arrived, before);
+            slack = max_epi64_sse4(slack, shift1_sse4(slack, lowest));
+            slack = max_epi64_sse4(slack, current);
+            start = _mm_add_epi64(before, slack);
+            current = last_lane_sse4(_mm_add_epi64(inclusive, slack));
+            last = current;
+        }
+        else
+        {
+            start = max_epi64_sse4(_mm_add_epi64(current, before), arrived);
+            last = max_epi64_sse4(last, _mm_add_epi64(start, burst));
+            current = _mm_add_epi64(current, last_lane_sse4(inclusive));
+        }
+        waits = _mm_add_epi64(waits, _mm_sub_epi64(start, arrived));
+        bursts = _mm_add_epi64(bursts, burst);
+    }
+
+    unsigned long last_low = (unsigned long)_mm_cvtsi128_si64(last);
+    unsigned long last_high = (unsigned long)_mm_extract_epi64(last, 1);
+    state->current_time = (unsigned long)_mm_cvtsi128_si64(current);
+    state->total_wait_time += (unsigned long)(_mm_cvtsi128_si64(waits) + _mm_extract_epi64(waits, 1));
+    state->total_burst_time += (unsigned long)(_mm_cvtsi128_si64(bursts) + _mm_extract_epi64(bursts, 1));
+    state->last_completion = last_low > last_high ? last_low : last_high;
+    state->count += i;
+    completion_kernel_scalar(burst_time + i, arrival + i, n - i, 1, idle_jumps_to_arrival, state);
+}
+
+completion_kernel_t pick_completion_kernel()
+{
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2"))
+    {
+        return completion_kernel_avx2_impl;
+    }
+    if (__builtin_cpu_supports("sse4.2"))
+    {
+        return completion_kernel_sse4_impl;
+    }
+    return completion_kernel_scalar;
+}
+
+}  // namespace
+
+const completion_kernel_t completion_kernel_sse4 = completion_kernel_sse4_impl;
+const completion_kernel_t completion_kernel_avx2 = completion_kernel_avx2_impl;
+
+#else
+
+namespace
+{
+
+completion_kernel_t pick_completion_kernel()
+{
+    return completion_kernel_scalar;
+}
+
+}  // namespace
+
+const completion_kernel_t completion_kernel_sse4 = NULL;
+const completion_kernel_t completion_kernel_avx2 = NULL;
+
+#endif
+
+completion_kernel_t completion_kernel()
+{
+    static const completion_kernel_t kernel = pick_completion_kernel();
+    return kernel;
+}
+
+//
+// Parallel pass
+//
+
+namespace
+{
+
+// 0 means one thread per core
+std::atomic<size_t> configured_threads(0);
+std::atomic<size_t> configured_sort_threshold(SCHEDULER_PARALLEL_SORT_THRESHOLD);
+
+struct PassBlock
+{
+    const uint32_t *burst_time;
+    const uint32_t *arrival;
+    size_t n;
+    CompletionState state;
+};
+
+void run_block(PassBlock *block, size_t stride, bool idle_jumps_to_arrival)
+{
+    completion_pass_serial(block->burst_time, block->arrival, block->n, stride, idle_jumps_to_arrival, &block->state);
+}
+
+// runs every block's pass, one block per thread with the caller taking block 0
+// blocks that get no thread run on the caller after its own, so every thread that started is joined
+void run_blocks(std::vector<PassBlock> &blocks, size_t stride, bool idle_jumps_to_arrival)
+{
+    std::vector<std::thread> workers(blocks.size());
+    for (size_t b = 1; b < blocks.size(); ++b)
+    {
+        try
+        {
+            workers[b] = std::thread(run_block, &blocks[b], stride, idle_jumps_to_arrival);
+        }
+        catch (const std::system_error &)
+        {
+            // left default constructed, not joinable
+        }
+    }
+    run_block(&blocks[0], stride, idle_jumps_to_arrival);
+    for (size_t b = 1; b < blocks.size(); ++b)
+    {
+        if (workers[b].joinable())
+        {
+            workers[b].join();
+        }
+        else
+        {
+            run_block(&blocks[b], stride, idle_jumps_to_arrival);
+        }
+    }
+}
+
+}  // namespace
+
+size_t pass_threads()
+{
+    size_t threads = configured_threads.load(std::memory_order_relaxed);
+    if (threads == 0)
+    {
+        threads = std::thread::hardware_concurrency();
+    }
+    return threads ? threads : 1;
+}
+
+void set_pass_threads(size_t threads)
+{
+    configured_threads.store(threads, std::memory_order_relaxed);
+}
+
+size_t parallel_sort_threshold()
+{
+    return configured_sort_threshold.load(std::memory_order_relaxed);
+}
+
+void set_parallel_sort_threshold(size_t pcbs)
+{
+    configured_sort_threshold.store(pcbs, std::memory_order_relaxed);
+}
+
+void completion_pass_parallel(const uint32_t *burst_time, const uint32_t *arrival, size_t n, size_t stride,
+                              bool idle_jumps_to_arrival, CompletionState *state, size_t threads)
+{
+    if (threads < 2 || n < threads)
+    {
+        completion_pass_serial(burst_time, arrival, n, stride, idle_jumps_to_arrival, state);
+        return;
+    }
+
+    std::vector<PassBlock> blocks(threads);
+    const CompletionState empty = {0, 0, 0, 0, 0};
+    for (size_t b = 0; b < threads; ++b)
+    {
+        size_t first = n / threads * b;
+        size_t last = b + 1 == threads ? n : n / threads * (b + 1);
+        PassBlock block = {burst_time + first * stride, arrival + first * stride, last - first, empty};
+        blocks[b] = block;
+    }
+
+    // Block summaries: starting from 0 every block's current_time is its finish and total_burst_time its bursts
+    run_blocks(blocks, stride, idle_jumps_to_arrival);
+
+    // Combine them in order into the time each block really starts
+    unsigned long current_time = state->current_time;
+    for (size_t b = 0; b < threads; ++b)
+    {
+        unsigned long busy = current_time + blocks[b].state.total_burst_time;
+        unsigned long next_time = idle_jumps_to_arrival && blocks[b].state.current_time > busy
+                                      ? blocks[b].state.current_time
+                                      : busy;
+        CompletionState start = {current_time, 0, 0, 0, 0};
+        blocks[b].state = start;
+        current_time = next_time;
+    }
+
+    // Account every block from its real start
+    run_blocks(blocks, stride, idle_jumps_to_arrival);
+
+    for (size_t b = 0; b < threads; ++b)
+    {
+        state->total_wait_time += blocks[b].state.total_wait_time;
+        state->total_burst_time += blocks[b].state.total_burst_time;
+        state->last_completion =
+            blocks[b].state.last_completion > state->last_completion ? blocks[b].state.last_completion : state->last_completion;
+        state->count += blocks[b].state.count;
+    }
+    state->current_time = blocks[threads - 1].state.current_time;
+}
+
+}  // namespace scheduler_engine
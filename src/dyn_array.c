@@ -1,19 +1,30 @@
+#define _GNU_SOURCE
+#include <pthread.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
 #include "dyn_array.h"
 
 // Flag values
 // SHRUNK to indicate shrink_to_fit was called and size needs to be corrected
 // SORTED to track if the objects have been sorted by us (sorted is set by sort and unset by insert/push)
-// these are just ideas
-// typedef enum {NONE = 0x00, SHRUNK = 0x01, SORTED = 0x02, ALL = 0xFF} DYN_FLAGS;
+// RING to indicate the storage is a circular buffer starting at head
+// VIEW to indicate the storage belongs to someone else and is read-only
+// SHRINK_ON_DRAIN to give memory back as removals empty the array
+// these are just ideas (SHRUNK, RING, VIEW and SHRINK_ON_DRAIN are real)
+typedef enum {NONE = 0x00, SHRUNK = 0x01, SORTED = 0x02, RING = 0x04, VIEW = 0x08, SHRINK_ON_DRAIN = 0x10, ALL = 0xFF} DYN_FLAGS;
 
 struct dyn_array 
 {
-	// DYN_FLAGS flags;
+	DYN_FLAGS flags;
 	size_t capacity;
 	size_t size;
 	const size_t data_size;
 	void *array;
 	void (*destructor)(void *);
+	size_t head;  // physical index of element 0, always 0 unless RING
+	size_t growth_percent;  // new capacity as a percentage of the old one when growing
+	dyn_allocator_t allocator;  // where the struct, storage and sort scratch come from
 };
 
 // Supports 64bit+ size_t!
@@ -28,6 +39,18 @@ struct dyn_array
 	(((uint8_t *) (dyn_array_ptr)->array) + ((idx) * (dyn_array_ptr)->data_size))
 // Gets the size (in bytes) of n dyn_array elements
 #define DYN_SIZE_N_ELEMS(dyn_array_ptr, n) ((dyn_array_ptr)->data_size * (n))
+// Physical index of logical index idx, wraps around for RING arrays (idx <= capacity)
+#define DYN_ARRAY_SLOT(dyn_array_ptr, idx)                                               \
+	(((dyn_array_ptr)->head + (idx)) >= (dyn_array_ptr)->capacity                        \
+		 ? ((dyn_array_ptr)->head + (idx)) - (dyn_array_ptr)->capacity                   \
+		 : ((dyn_array_ptr)->head + (idx)))
+// Address of logical index idx
+#define DYN_ARRAY_LOGICAL_POSITION(dyn_array_ptr, idx) DYN_ARRAY_POSITION(dyn_array_ptr, DYN_ARRAY_SLOT(dyn_array_ptr, idx))
+#define DYN_IS_RING(dyn_array_ptr) ((dyn_array_ptr)->flags & RING)
+#define DYN_IS_VIEW(dyn_array_ptr) ((dyn_array_ptr)->flags & VIEW)
+
+// smallest capacity create hands out, and where a shrunk array starts regrowing from
+#define DYN_MIN_CAPACITY 16
 
 
 
@@ -43,19 +66,54 @@ bool dyn_shift_insert(dyn_array_t *const dyn_array, const size_t position, const
 bool dyn_shift_remove(dyn_array_t *const dyn_array, const size_t position, const size_t count,
 					  const DYN_SHIFT_MODE mode, void *const data_dst);
 
+// Rotates a RING array so element 0 is at physical index 0 and the contents are contiguous
+bool dyn_linearize(dyn_array_t *const dyn_array);
+
+// Checks to see if the object can handle an increase in size (and optionally increases capacity)
+bool dyn_request_size_increase(dyn_array_t *const dyn_array, const size_t increment);
+
+// Shared by the create functions
+dyn_array_t *dyn_array_create_flags(const size_t capacity, const size_t data_type_size,
+									void (*destruct_func)(void *), const DYN_FLAGS flags,
+									const dyn_allocator_t *const allocator);
+
+// Shorthand for going through the array's allocator
+#define DYN_ALLOC(dyn_array_ptr, size) ((dyn_array_ptr)->allocator.alloc((dyn_array_ptr)->allocator.context, (size)))
+#define DYN_FREE(dyn_array_ptr, ptr, size) \
+	((dyn_array_ptr)->allocator.free((dyn_array_ptr)->allocator.context, (ptr), (size)))
+
 
 
 
 dyn_array_t *dyn_array_create(const size_t capacity, const size_t data_type_size, void (*destruct_func)(void *)) 
 {
-	if (data_type_size && capacity <= DYN_MAX_CAPACITY) 
+	return dyn_array_create_flags(capacity, data_type_size, destruct_func, NONE, &dyn_default_allocator);
+}
+
+dyn_array_t *dyn_array_create_with_allocator(const size_t capacity, const size_t data_type_size,
+											 void (*destruct_func)(void *), const dyn_allocator_t *const allocator) 
+{
+	return dyn_array_create_flags(capacity, data_type_size, destruct_func, NONE,
+								  allocator ? allocator : &dyn_default_allocator);
+}
+
+dyn_array_t *dyn_array_create_ring(const size_t capacity, const size_t data_type_size, void (*destruct_func)(void *)) 
+{
+	return dyn_array_create_flags(capacity, data_type_size, destruct_func, RING, &dyn_default_allocator);
+}
+
+dyn_array_t *dyn_array_create_flags(const size_t capacity, const size_t data_type_size,
+									void (*destruct_func)(void *), const DYN_FLAGS flags,
+									const dyn_allocator_t *const allocator) 
+{
+	if (data_type_size && capacity <= DYN_MAX_CAPACITY && allocator->alloc && allocator->realloc && allocator->free) 
 	{
-		dyn_array_t *dyn_array = (dyn_array_t *) malloc(sizeof(dyn_array_t));
+		dyn_array_t *dyn_array = (dyn_array_t *) allocator->alloc(allocator->context, sizeof(dyn_array_t));
 		if (dyn_array) 
 		{
 			// would have inf loop if requested size was between DYN_MAX_CAPACITY
 			// and SIZE_MAX
-			size_t actual_capacity = 16;
+			size_t actual_capacity = DYN_MIN_CAPACITY;
 			while (capacity > actual_capacity) 
 			{
 				actual_capacity <<= 1;
@@ -70,8 +128,9 @@ dyn_array_t *dyn_array_create(const size_t capacity, const size_t data_type_size
 
 			// I had an idea... and it compiles
 			// const members of a malloc'd struct are so annoying
-			memcpy(dyn_array, &((dyn_array_t){actual_capacity, 0, data_type_size,
-											  malloc(data_type_size * actual_capacity), destruct_func}),
+			memcpy(dyn_array, &((dyn_array_t){flags, actual_capacity, 0, data_type_size,
+											  allocator->alloc(allocator->context, data_type_size * actual_capacity),
+											  destruct_func, 0, DYN_DEFAULT_GROWTH_PERCENT, *allocator}),
 				   sizeof(dyn_array_t));
 
 			if (dyn_array->array) 
@@ -80,7 +139,42 @@ dyn_array_t *dyn_array_create(const size_t capacity, const size_t data_type_size
 				// we're done?
 				return dyn_array;
 			}
-			free(dyn_array);
+			allocator->free(allocator->context, dyn_array, sizeof(dyn_array_t));
+		}
+	}
+	return NULL;
+}
+
+// Takes over a malloc'd array, nothing to allocate but the struct
+dyn_array_t *dyn_array_adopt(void *const data, const size_t count, const size_t data_type_size,
+							 void (*destruct_func)(void *)) 
+{
+	if (data && count && data_type_size && count <= DYN_MAX_CAPACITY) 
+	{
+		dyn_array_t *dyn_array = (dyn_array_t *) malloc(sizeof(dyn_array_t));
+		if (dyn_array) 
+		{
+			memcpy(dyn_array, &((dyn_array_t){NONE, count, count, data_type_size, data, destruct_func, 0,
+											  DYN_DEFAULT_GROWTH_PERCENT, dyn_default_allocator}),
+				   sizeof(dyn_array_t));
+			return dyn_array;
+		}
+	}
+	return NULL;
+}
+
+// Wraps someone else's array, nothing to allocate but the struct
+dyn_array_t *dyn_array_create_view(const void *const data, const size_t count, const size_t data_type_size) 
+{
+	if (data && count && data_type_size && count <= DYN_MAX_CAPACITY) 
+	{
+		dyn_array_t *dyn_array = (dyn_array_t *) malloc(sizeof(dyn_array_t));
+		if (dyn_array) 
+		{
+			memcpy(dyn_array, &((dyn_array_t){VIEW, count, count, data_type_size, (void *) data, NULL, 0,
+											  DYN_DEFAULT_GROWTH_PERCENT, dyn_default_allocator}),
+				   sizeof(dyn_array_t));
+			return dyn_array;
 		}
 	}
 	return NULL;
@@ -113,15 +207,26 @@ dyn_array_t *dyn_array_import(const void *const data, const size_t count, const
 // exporting then changing isn't safe since it's all the same data
 const void *dyn_array_export(const dyn_array_t *const dyn_array) 
 {
+	// exporting a wrapped ring has to hand out contiguous data
+	// the contents don't change, only where they live, so casting away const is fair
+	if (dyn_array && DYN_IS_RING(dyn_array) && !dyn_linearize((dyn_array_t *) dyn_array)) 
+	{
+		return NULL;
+	}
 	return dyn_array_front(dyn_array);
 }
 
 void dyn_array_destroy(dyn_array_t *dyn_array) 
 {
 	if (dyn_array) {
-		dyn_array_clear(dyn_array);
-		free(dyn_array->array);
-		free(dyn_array);
+		if (!DYN_IS_VIEW(dyn_array)) 
+		{
+			dyn_array_clear(dyn_array);
+			DYN_FREE(dyn_array, dyn_array->array, DYN_SIZE_N_ELEMS(dyn_array, dyn_array->capacity));
+		}
+		// the struct holds the allocator, so it can't free itself through it
+		const dyn_allocator_t allocator = dyn_array->allocator;
+		allocator.free(allocator.context, dyn_array, sizeof(dyn_array_t));
 	}
 }
 
@@ -135,7 +240,7 @@ void *dyn_array_front(const dyn_array_t *const dyn_array)
 		// If array is null, well, this is ok, because it's null
 		// but if array is broken, well, we can't help that
 		// nor can we detect that, so I guess it's not an error
-		return dyn_array->array;
+		return DYN_ARRAY_POSITION(dyn_array, dyn_array->head);
 	}
 	return NULL;
 }
@@ -155,6 +260,12 @@ bool dyn_array_extract_front(dyn_array_t *const dyn_array, void *const object)
 	return dyn_shift_remove(dyn_array, 0, 1, MODE_EXTRACT, object);
 }
 
+bool dyn_array_extract_front_n(dyn_array_t *const dyn_array, void *const objects, const size_t count) 
+{
+	// all or nothing, asking for more than there is takes nothing
+	return dyn_shift_remove(dyn_array, 0, count, MODE_EXTRACT, objects);
+}
+
 
 
 
@@ -162,7 +273,7 @@ void *dyn_array_back(const dyn_array_t *const dyn_array)
 {
 	if (dyn_array && dyn_array->size) 
 	{
-		return DYN_ARRAY_POSITION(dyn_array, dyn_array->size - 1);
+		return DYN_ARRAY_LOGICAL_POSITION(dyn_array, dyn_array->size - 1);
 	}
 	return NULL;
 }
@@ -172,6 +283,13 @@ bool dyn_array_push_back(dyn_array_t *const dyn_array, const void *const object)
 	return dyn_array && dyn_shift_insert(dyn_array, dyn_array->size, 1, MODE_INSERT, (void *const) object);
 }
 
+bool dyn_array_push_back_n(dyn_array_t *const dyn_array, const void *const objects, const size_t count) 
+{
+	// one capacity check and one copy for the lot
+	return dyn_array && count <= DYN_MAX_CAPACITY
+		   && dyn_shift_insert(dyn_array, dyn_array->size, count, MODE_INSERT, objects);
+}
+
 bool dyn_array_pop_back(dyn_array_t *const dyn_array) 
 {
 	// Assert size because rollunder is scary, (though it should be handled correctly)
@@ -189,7 +307,7 @@ void *dyn_array_at(const dyn_array_t *const dyn_array, const size_t index)
 {
 	if (dyn_array && index < dyn_array->size) 
 	{
-		return DYN_ARRAY_POSITION(dyn_array, index);
+		return DYN_ARRAY_LOGICAL_POSITION(dyn_array, index);
 	}
 	return NULL;
 }
@@ -201,11 +319,24 @@ bool dyn_array_insert(dyn_array_t *const dyn_array, const size_t index, const vo
 	return object && dyn_shift_insert(dyn_array, index, 1, MODE_INSERT, object);
 }
 
+bool dyn_array_insert_n(dyn_array_t *const dyn_array, const size_t index, const void *const objects,
+						const size_t count) 
+{
+	return count <= DYN_MAX_CAPACITY && dyn_shift_insert(dyn_array, index, count, MODE_INSERT, objects);
+}
+
 bool dyn_array_erase(dyn_array_t *const dyn_array, const size_t index) 
 {
 	return dyn_shift_remove(dyn_array, index, 1, MODE_ERASE, NULL);
 }
 
+bool dyn_array_erase_range(dyn_array_t *const dyn_array, const size_t index, const size_t count) 
+{
+	// dyn_shift_remove adds index and count, keep that from wrapping around
+	return dyn_array && index <= dyn_array->size && count <= dyn_array->size - index
+		   && dyn_shift_remove(dyn_array, index, count, MODE_ERASE, NULL);
+}
+
 bool dyn_array_extract(dyn_array_t *const dyn_array, const size_t index, void *const object) 
 {
 	return dyn_array && object && dyn_array->size > index
@@ -259,7 +390,7 @@ bool dyn_array_sort(dyn_array_t *const dyn_array, int (*const compare)(const voi
 {
 	// hah, turns out there's a quicksort in cstdlib.
 	// and it works exactly like we want it to
-	if (dyn_array && dyn_array->size && compare) 
+	if (dyn_array && dyn_array->size && compare && !DYN_IS_VIEW(dyn_array) && dyn_linearize(dyn_array)) 
 	{
 		qsort(dyn_array->array, dyn_array->size, dyn_array->data_size, compare);
 		return true;
@@ -268,21 +399,442 @@ bool dyn_array_sort(dyn_array_t *const dyn_array, int (*const compare)(const voi
 }
 
 
+// Radix sort works a byte at a time, so a pair of keys is 8 passes
+#define DYN_RADIX_PASSES_PER_KEY 4
+#define DYN_RADIX_BUCKETS 256
+
+bool dyn_array_sort_by_u32_key(dyn_array_t *const dyn_array, const size_t key_offset, const size_t tiebreak_offset) 
+{
+	if (!dyn_array || !dyn_array->size || DYN_IS_VIEW(dyn_array) || key_offset > dyn_array->data_size - sizeof(uint32_t)
+		|| dyn_array->data_size < sizeof(uint32_t)
+		|| (tiebreak_offset != DYN_NO_TIEBREAK && tiebreak_offset > dyn_array->data_size - sizeof(uint32_t))) 
+	{
+		return false;
+	}
+	if (!dyn_linearize(dyn_array)) 
+	{
+		return false;
+	}
+
+	// LSD: least significant digit first, so the tiebreak key goes before the primary key
+	size_t offsets[2 * DYN_RADIX_PASSES_PER_KEY];
+	size_t pass_count = 0;
+	if (tiebreak_offset != DYN_NO_TIEBREAK) 
+	{
+		for (size_t byte = 0; byte < DYN_RADIX_PASSES_PER_KEY; ++byte) 
+		{
+			offsets[pass_count++] = tiebreak_offset;
+		}
+	}
+	for (size_t byte = 0; byte < DYN_RADIX_PASSES_PER_KEY; ++byte) 
+	{
+		offsets[pass_count++] = key_offset;
+	}
+
+	// one read over the data counts every digit of every pass
+	size_t (*counts)[DYN_RADIX_BUCKETS] = calloc(pass_count, sizeof(*counts));
+	if (!counts) 
+	{
+		return false;
+	}
+	uint8_t *walker = (uint8_t *) dyn_array->array;
+	for (size_t idx = 0; idx < dyn_array->size; ++idx, walker += dyn_array->data_size) 
+	{
+		for (size_t pass = 0; pass < pass_count; ++pass) 
+		{
+			uint32_t key;
+			memcpy(&key, walker + offsets[pass], sizeof(uint32_t));
+			++counts[pass][(key >> ((pass % DYN_RADIX_PASSES_PER_KEY) << 3)) & 0xFF];
+		}
+	}
+
+	// scratch matches the capacity so the two buffers can trade places
+	uint8_t *src = (uint8_t *) dyn_array->array;
+	uint8_t *dst = NULL;
+	for (size_t pass = 0; pass < pass_count; ++pass) 
+	{
+		const unsigned shift = (pass % DYN_RADIX_PASSES_PER_KEY) << 3;
+		// a digit everyone shares can't change the order, skip it (small keys skip their high bytes)
+		uint32_t first_key;
+		memcpy(&first_key, src + offsets[pass], sizeof(uint32_t));
+		if (counts[pass][(first_key >> shift) & 0xFF] == dyn_array->size) 
+		{
+			continue;
+		}
+		if (!dst) 
+		{
+			dst = (uint8_t *) DYN_ALLOC(dyn_array, DYN_SIZE_N_ELEMS(dyn_array, dyn_array->capacity));
+			if (!dst) 
+			{
+				free(counts);
+				return false;
+			}
+		}
+		// bucket counts to starting positions
+		size_t position = 0;
+		for (size_t bucket = 0; bucket < DYN_RADIX_BUCKETS; ++bucket) 
+		{
+			size_t count			= counts[pass][bucket];
+			counts[pass][bucket] = position;
+			position += count;
+		}
+		walker = src;
+		for (size_t idx = 0; idx < dyn_array->size; ++idx, walker += dyn_array->data_size) 
+		{
+			uint32_t key;
+			memcpy(&key, walker + offsets[pass], sizeof(uint32_t));
+			memcpy(dst + DYN_SIZE_N_ELEMS(dyn_array, counts[pass][(key >> shift) & 0xFF]++), walker,
+				   dyn_array->data_size);
+		}
+		uint8_t *swap = src;
+		src			  = dst;
+		dst			  = swap;
+	}
+	free(counts);
+
+	// src holds the sorted data, dst is whichever buffer is left over (if any)
+	dyn_array->array = src;
+	if (dst) 
+	{
+		DYN_FREE(dyn_array, dst, DYN_SIZE_N_ELEMS(dyn_array, dyn_array->capacity));
+	}
+	return true;
+}
+
+
+// Parallel merge sort
+// Every merge is cut into pieces at evenly spaced output positions (a binary search finds where each piece
+// starts in the two inputs), so the last rounds with only a couple of runs left still keep every thread busy
+
+// runs shorter than this aren't worth a thread
+#define DYN_PARALLEL_SORT_MIN_RUN 4096
+#define DYN_PARALLEL_SORT_MAX_THREADS 256
+// the serial merge sort insertion sorts runs this long first
+#define DYN_INSERTION_RUN 16
+
+typedef int (*dyn_compare_t)(const void *, const void *);
+
+// How many of the first k merged objects come from a, equal objects take a first so merging is stable
+static size_t dyn_merge_split(const uint8_t *a, const size_t a_count, const uint8_t *b, const size_t b_count,
+							  const size_t k, const size_t data_size, const dyn_compare_t compare) 
+{
+	size_t low  = k > b_count ? k - b_count : 0;
+	size_t high = k < a_count ? k : a_count;
+	while (low < high) 
+	{
+		size_t i = low + (high - low) / 2;
+		// a[i] goes before b[k - i - 1], so more than i objects come from a
+		if (compare(a + i * data_size, b + (k - i - 1) * data_size) <= 0) 
+		{
+			low = i + 1;
+		} 
+		else 
+		{
+			high = i;
+		}
+	}
+	return low;
+}
+
+// Writes merged objects k up to k + count of the stable merge of a and b to out + k
+static void dyn_merge_range(const uint8_t *a, const size_t a_count, const uint8_t *b, const size_t b_count,
+							uint8_t *out, const size_t k, const size_t count, const size_t data_size,
+							const dyn_compare_t compare) 
+{
+	size_t i	 = dyn_merge_split(a, a_count, b, b_count, k, data_size, compare);
+	size_t j	 = k - i;
+	uint8_t *dst = out + k * data_size;
+	for (size_t written = 0; written < count; ++written, dst += data_size) 
+	{
+		if (j < b_count && (i >= a_count || compare(b + j * data_size, a + i * data_size) < 0)) 
+		{
+			memcpy(dst, b + j++ * data_size, data_size);
+		} 
+		else 
+		{
+			memcpy(dst, a + i++ * data_size, data_size);
+		}
+	}
+}
+
+// Stable bottom up merge sort, scratch holds count objects and the result ends up in data
+static void dyn_merge_sort(uint8_t *data, uint8_t *scratch, const size_t count, const size_t data_size,
+						   const dyn_compare_t compare) 
+{
+	// insertion sort is stable and quick on short runs, scratch holds the object being placed
+	for (size_t start = 0; start < count; start += DYN_INSERTION_RUN) 
+	{
+		size_t end = start + DYN_INSERTION_RUN < count ? start + DYN_INSERTION_RUN : count;
+		for (size_t idx = start + 1; idx < end; ++idx) 
+		{
+			memcpy(scratch, data + idx * data_size, data_size);
+			size_t position = idx;
+			for (; position > start && compare(data + (position - 1) * data_size, scratch) > 0; --position) 
+			{
+				memcpy(data + position * data_size, data + (position - 1) * data_size, data_size);
+			}
+			memcpy(data + position * data_size, scratch, data_size);
+		}
+	}
+
+	uint8_t *src = data;
+	uint8_t *dst = scratch;
+	for (size_t width = DYN_INSERTION_RUN; width < count; width <<= 1) 
+	{
+		for (size_t start = 0; start < count; start += width << 1) 
+		{
+			size_t mid = start + width < count ? start + width : count;
+			size_t end = mid + width < count ? mid + width : count;
+			dyn_merge_range(src + start * data_size, mid - start, src + mid * data_size, end - mid,
+							dst + start * data_size, 0, end - start, data_size, compare);
+		}
+		uint8_t *swap = src;
+		src			  = dst;
+		dst			  = swap;
+	}
+	if (src != data) 
+	{
+		memcpy(data, src, count * data_size);
+	}
+}
+
+typedef struct 
+{
+	uint8_t *src;			// where the runs are
+	uint8_t *dst;			// where merged runs go (scratch space while the runs are sorted)
+	size_t data_size;
+	dyn_compare_t compare;
+	bool stable;
+	const size_t *bounds;	// run r is [bounds[r], bounds[r + 1])
+	size_t runs;
+	size_t width;			// runs already merged together, 0 while the runs are being sorted
+	size_t thread;			// this worker's run, or its share of the output while merging
+} dyn_sort_worker_t;
+
+static void *dyn_sort_worker(void *arg) 
+{
+	const dyn_sort_worker_t *work = (const dyn_sort_worker_t *) arg;
+	const size_t data_size		   = work->data_size;
+	if (work->width == 0) 
+	{
+		size_t first = work->bounds[work->thread];
+		size_t count = work->bounds[work->thread + 1] - first;
+		if (work->stable) 
+		{
+			dyn_merge_sort(work->src + first * data_size, work->dst + first * data_size, count, data_size,
+						   work->compare);
+		} 
+		else 
+		{
+			qsort(work->src + first * data_size, count, data_size, work->compare);
+		}
+		return NULL;
+	}
+
+	// an even share of the output, whichever merges it lands in
+	const size_t total	   = work->bounds[work->runs];
+	const size_t out_begin = total / work->runs * work->thread;
+	const size_t out_end   = work->thread + 1 == work->runs ? total : total / work->runs * (work->thread + 1);
+	for (size_t first = 0; first < work->runs; first += work->width << 1) 
+	{
+		size_t middle_run = first + work->width < work->runs ? first + work->width : work->runs;
+		size_t end_run	  = middle_run + work->width < work->runs ? middle_run + work->width : work->runs;
+		size_t low		  = work->bounds[first];
+		size_t middle	  = work->bounds[middle_run];
+		size_t high		  = work->bounds[end_run];
+		if (high <= out_begin || low >= out_end) 
+		{
+			continue;
+		}
+		size_t k_begin = (low > out_begin ? low : out_begin) - low;
+		size_t k_end   = (high < out_end ? high : out_end) - low;
+		dyn_merge_range(work->src + low * data_size, middle - low, work->src + middle * data_size, high - middle,
+						work->dst + low * data_size, k_begin, k_end - k_begin, data_size, work->compare);
+	}
+	return NULL;
+}
+
+// Runs every worker on its own thread with the caller taking the first
+// A worker whose thread can't be started runs on the caller instead, so this can't fail
+static void dyn_run_sort_workers(dyn_sort_worker_t *workers, const size_t threads) 
+{
+	pthread_t ids[DYN_PARALLEL_SORT_MAX_THREADS];
+	bool started[DYN_PARALLEL_SORT_MAX_THREADS];
+	for (size_t thread = 1; thread < threads; ++thread) 
+	{
+		started[thread] = pthread_create(&ids[thread], NULL, dyn_sort_worker, &workers[thread]) == 0;
+	}
+	dyn_sort_worker(&workers[0]);
+	for (size_t thread = 1; thread < threads; ++thread) 
+	{
+		if (started[thread]) 
+		{
+			pthread_join(ids[thread], NULL);
+		} 
+		else 
+		{
+			dyn_sort_worker(&workers[thread]);
+		}
+	}
+}
+
+bool dyn_array_sort_parallel(dyn_array_t *const dyn_array, int (*const compare)(const void *, const void *),
+							 const size_t nthreads, const bool stable) 
+{
+	if (!dyn_array || !dyn_array->size || !compare || DYN_IS_VIEW(dyn_array) || !dyn_linearize(dyn_array)) 
+	{
+		return false;
+	}
+
+	size_t threads = nthreads;
+	if (threads == 0) 
+	{
+		long online = sysconf(_SC_NPROCESSORS_ONLN);
+		threads		= online > 0 ? (size_t) online : 1;
+	}
+	if (threads > dyn_array->size / DYN_PARALLEL_SORT_MIN_RUN) 
+	{
+		threads = dyn_array->size / DYN_PARALLEL_SORT_MIN_RUN;
+	}
+	if (threads > DYN_PARALLEL_SORT_MAX_THREADS) 
+	{
+		threads = DYN_PARALLEL_SORT_MAX_THREADS;
+	}
+	if (threads < 2 && !stable) 
+	{
+		return dyn_array_sort(dyn_array, compare);
+	}
+	threads = threads ? threads : 1;
+
+	// scratch matches the capacity so the two buffers can trade places
+	uint8_t *scratch = (uint8_t *) DYN_ALLOC(dyn_array, DYN_SIZE_N_ELEMS(dyn_array, dyn_array->capacity));
+	if (!scratch) 
+	{
+		return false;
+	}
+
+	size_t bounds[DYN_PARALLEL_SORT_MAX_THREADS + 1];
+	for (size_t run = 0; run < threads; ++run) 
+	{
+		bounds[run] = dyn_array->size / threads * run;
+	}
+	bounds[threads] = dyn_array->size;
+
+	dyn_sort_worker_t workers[DYN_PARALLEL_SORT_MAX_THREADS];
+	for (size_t thread = 0; thread < threads; ++thread) 
+	{
+		dyn_sort_worker_t worker = {(uint8_t *) dyn_array->array, scratch, dyn_array->data_size, compare, stable,
+									bounds, threads, 0, thread};
+		workers[thread] = worker;
+	}
+	dyn_run_sort_workers(workers, threads);
+
+	// the runs were sorted in place, now merge neighbours back and forth between the two buffers
+	uint8_t *src = (uint8_t *) dyn_array->array;
+	uint8_t *dst = scratch;
+	for (size_t width = 1; width < threads; width <<= 1) 
+	{
+		for (size_t thread = 0; thread < threads; ++thread) 
+		{
+			workers[thread].src	  = src;
+			workers[thread].dst	  = dst;
+			workers[thread].width = width;
+		}
+		dyn_run_sort_workers(workers, threads);
+		uint8_t *swap = src;
+		src			  = dst;
+		dst			  = swap;
+	}
+
+	dyn_array->array = src;
+	if (dst) 
+	{
+		DYN_FREE(dyn_array, dst, DYN_SIZE_N_ELEMS(dyn_array, dyn_array->capacity));
+	}
+	return true;
+}
+
+
+// First logical index in [low, high) whose object compares greater than object (high if there isn't one)
+// Rings are searched where they are, only the insert itself may have to unwrap them
+static size_t dyn_upper_bound(const dyn_array_t *const dyn_array, size_t low, size_t high, const void *const object,
+							  const dyn_compare_t compare) 
+{
+	while (low < high) 
+	{
+		const size_t mid = low + (high - low) / 2;
+		if (compare(object, DYN_ARRAY_LOGICAL_POSITION(dyn_array, mid)) < 0) 
+		{
+			high = mid;
+		} 
+		else 
+		{
+			low = mid + 1;
+		}
+	}
+	return low;
+}
+
 bool dyn_array_insert_sorted(dyn_array_t *const dyn_array, const void *const object,
 							 int (*const compare)(const void *, const void *)) 
 {
 	if (dyn_array && compare && object) 
 	{
-		size_t ordered_position = 0;
-		if (dyn_array->size) 
+		// after any equal objects, so equal objects stay in the order they were inserted
+		const size_t ordered_position = dyn_upper_bound(dyn_array, 0, dyn_array->size, object, compare);
+		return dyn_shift_insert(dyn_array, ordered_position, 1, MODE_INSERT, object);
+	}
+	return false;
+}
+
+bool dyn_array_insert_sorted_many(dyn_array_t *const dyn_array, const void *const data, const size_t count,
+								  int (*const compare)(const void *, const void *)) 
+{
+	if (dyn_array && data && count && compare && !DYN_IS_VIEW(dyn_array)
+		&& count <= (SIZE_MAX >> 1) / dyn_array->data_size) 
+	{
+		if (count == 1) 
 		{
-			while (ordered_position < dyn_array->size
-				   && compare(object, DYN_ARRAY_POSITION(dyn_array, ordered_position)) > 0) 
+			return dyn_array_insert_sorted(dyn_array, data, compare);
+		}
+		const size_t data_size	 = dyn_array->data_size;
+		const size_t batch_bytes = DYN_SIZE_N_ELEMS(dyn_array, count);
+		// the batch is sorted in a copy (it's the caller's), with the merge sort's scratch right behind it
+		uint8_t *batch = (uint8_t *) DYN_ALLOC(dyn_array, batch_bytes << 1);
+		if (!batch) 
+		{
+			return false;
+		}
+		memcpy(batch, data, batch_bytes);
+		dyn_merge_sort(batch, batch + batch_bytes, count, data_size, compare);
+
+		bool success = dyn_linearize(dyn_array) && dyn_request_size_increase(dyn_array, count);
+		if (success) 
+		{
+			// merge from the back into the grown array, so nothing is overwritten before it has moved
+			// and everything in front of the batch's first slot is never touched
+			// ties take the batch object first (it's going behind), same as inserting them one at a time
+			size_t existing	 = dyn_array->size;
+			size_t incoming	 = count;
+			uint8_t *dst	 = DYN_ARRAY_POSITION(dyn_array, existing + count);
+			while (incoming) 
 			{
-				++ordered_position;
+				dst -= data_size;
+				const uint8_t *next = batch + (incoming - 1) * data_size;
+				if (existing && compare(DYN_ARRAY_POSITION(dyn_array, existing - 1), next) > 0) 
+				{
+					memcpy(dst, DYN_ARRAY_POSITION(dyn_array, --existing), data_size);
+				} 
+				else 
+				{
+					memcpy(dst, next, data_size);
+					--incoming;
+				}
 			}
+			dyn_array->size += count;
 		}
-		return dyn_shift_insert(dyn_array, ordered_position, 1, MODE_INSERT, object);
+		DYN_FREE(dyn_array, batch, batch_bytes << 1);
+		return success;
 	}
 	return false;
 }
@@ -290,7 +842,8 @@ bool dyn_array_insert_sorted(dyn_array_t *const dyn_array, const void *const obj
 
 bool dyn_array_for_each(dyn_array_t *const dyn_array, void (*const func)(void *const, void *), void *arg) 
 {
-	if (dyn_array && dyn_array->array && func) 
+	// func gets writable pointers, which a view's (possibly read-only mapped) data can't hand out
+	if (dyn_array && dyn_array->array && func && !DYN_IS_VIEW(dyn_array) && dyn_linearize(dyn_array)) 
 	{
 		// So I just noticed we never check the data array ever
 		// Which is both unsafe and potentially undefined behavior
@@ -311,18 +864,42 @@ bool dyn_array_for_each(dyn_array_t *const dyn_array, void (*const func)(void *c
 }
 
 
-/*
-	// No return value. It either goes or it doesn't. shrink_to_fit is more of a request
-	void dyn_array_shrink_to_fit(dyn_array_t *const dyn_array) {
-	if (dyn_array) {
-		void *new_address = realloc(dyn_array->data, DYN_ARRAY_SIZE_N_ELEMS(dyn_array, dyn_array->size));
-		if (new_address) {
-			dyn_array->data = new_address;
-			SET_FLAG(dyn_array,SHRUNK);
+// Reallocates the storage to exactly new_capacity objects, which must hold the contents
+bool dyn_set_capacity(dyn_array_t *const dyn_array, const size_t new_capacity);
+
+bool dyn_array_reserve(dyn_array_t *const dyn_array, const size_t capacity) 
+{
+	if (dyn_array && !DYN_IS_VIEW(dyn_array) && capacity <= DYN_MAX_CAPACITY) 
+	{
+		return capacity <= dyn_array->capacity || dyn_set_capacity(dyn_array, capacity);
+	}
+	return false;
+}
+
+// No return value. It either goes or it doesn't. shrink_to_fit is more of a request
+void dyn_array_shrink_to_fit(dyn_array_t *const dyn_array) 
+{
+	// realloc to 0 is its own can of worms, keep room for one
+	if (dyn_array && !DYN_IS_VIEW(dyn_array)) 
+	{
+		const size_t fit = dyn_array->size ? dyn_array->size : 1;
+		if (fit < dyn_array->capacity && dyn_set_capacity(dyn_array, fit)) 
+		{
+			dyn_array->flags |= SHRUNK;
 		}
 	}
+}
+
+bool dyn_array_set_growth(dyn_array_t *const dyn_array, const size_t growth_percent, const bool shrink_on_drain) 
+{
+	if (dyn_array && growth_percent > 100 && !DYN_IS_VIEW(dyn_array)) 
+	{
+		dyn_array->growth_percent = growth_percent;
+		dyn_array->flags = shrink_on_drain ? (dyn_array->flags | SHRINK_ON_DRAIN) : (dyn_array->flags & ~SHRINK_ON_DRAIN);
+		return true;
 	}
-*/
+	return false;
+}
 
 
 
@@ -334,8 +911,74 @@ bool dyn_array_for_each(dyn_array_t *const dyn_array, void (*const func)(void *c
 //
 
 
-// Checks to see if the object can handle an increase in size (and optionally increases capacity)
-bool dyn_request_size_increase(dyn_array_t *const dyn_array, const size_t increment);
+// After a removal, halves the capacity of a SHRINK_ON_DRAIN array once it's down to a quarter full
+// (a quarter, not a half, so pushing and popping around the line doesn't realloc every time)
+void dyn_drain_shrink(dyn_array_t *const dyn_array) 
+{
+	if ((dyn_array->flags & SHRINK_ON_DRAIN) && dyn_array->capacity > DYN_MIN_CAPACITY
+		&& dyn_array->size <= dyn_array->capacity / 4) 
+	{
+		const size_t half = dyn_array->capacity / 2;
+		// failing to shrink isn't an error, the memory just stays
+		dyn_set_capacity(dyn_array, half > DYN_MIN_CAPACITY ? half : DYN_MIN_CAPACITY);
+	}
+}
+
+// Copies count objects in/out of a ring starting at logical position, splitting the copy at the wrap
+// [C][D][?][?][A][B]  <- head is 4, copying 4 out from 0 is [A][B] then [C][D]
+void dyn_ring_copy_in(dyn_array_t *const dyn_array, const size_t position, const size_t count,
+					  const void *const data_src) 
+{
+	const size_t slot  = DYN_ARRAY_SLOT(dyn_array, position);
+	const size_t first = (dyn_array->capacity - slot) < count ? (dyn_array->capacity - slot) : count;
+	memcpy(DYN_ARRAY_POSITION(dyn_array, slot), data_src, DYN_SIZE_N_ELEMS(dyn_array, first));
+	if (first != count) 
+	{
+		memcpy(dyn_array->array, ((const uint8_t *) data_src) + DYN_SIZE_N_ELEMS(dyn_array, first),
+			   DYN_SIZE_N_ELEMS(dyn_array, count - first));
+	}
+}
+
+void dyn_ring_copy_out(const dyn_array_t *const dyn_array, const size_t position, const size_t count,
+					   void *const data_dst) 
+{
+	const size_t slot  = DYN_ARRAY_SLOT(dyn_array, position);
+	const size_t first = (dyn_array->capacity - slot) < count ? (dyn_array->capacity - slot) : count;
+	memcpy(data_dst, DYN_ARRAY_POSITION(dyn_array, slot), DYN_SIZE_N_ELEMS(dyn_array, first));
+	if (first != count) 
+	{
+		memcpy(((uint8_t *) data_dst) + DYN_SIZE_N_ELEMS(dyn_array, first), dyn_array->array,
+			   DYN_SIZE_N_ELEMS(dyn_array, count - first));
+	}
+}
+
+bool dyn_linearize(dyn_array_t *const dyn_array) 
+{
+	if (dyn_array->head == 0) 
+	{
+		return true;  // regular arrays always end up here
+	}
+	if (dyn_array->head + dyn_array->size <= dyn_array->capacity) 
+	{
+		// not wrapped, just slide it down
+		memmove(dyn_array->array, DYN_ARRAY_POSITION(dyn_array, dyn_array->head),
+				DYN_SIZE_N_ELEMS(dyn_array, dyn_array->size));
+	} 
+	else 
+	{
+		// wrapped, easiest to copy it out in order and swap buffers
+		void *new_array = DYN_ALLOC(dyn_array, DYN_SIZE_N_ELEMS(dyn_array, dyn_array->capacity));
+		if (!new_array) 
+		{
+			return false;
+		}
+		dyn_ring_copy_out(dyn_array, 0, dyn_array->size, new_array);
+		DYN_FREE(dyn_array, dyn_array->array, DYN_SIZE_N_ELEMS(dyn_array, dyn_array->capacity));
+		dyn_array->array = new_array;
+	}
+	dyn_array->head = 0;
+	return true;
+}
 
 #define MODE_IS_TYPE(mode, type) ((mode) & (type))
 
@@ -350,12 +993,27 @@ bool dyn_request_size_increase(dyn_array_t *const dyn_array, const size_t increm
 bool dyn_shift_insert(dyn_array_t *const dyn_array, const size_t position, const size_t count,
 					  const DYN_SHIFT_MODE mode, const void *const data_src) 
 {
-	if (dyn_array && count && mode == MODE_INSERT && data_src) 
+	if (dyn_array && count && mode == MODE_INSERT && data_src && !DYN_IS_VIEW(dyn_array)) 
 	{
+		// Rings insert at either end without moving anything, just write around the wrap
+		if (DYN_IS_RING(dyn_array) && (position == 0 || position == dyn_array->size)) 
+		{
+			if (dyn_request_size_increase(dyn_array, count)) 
+			{
+				if (position == 0) 
+				{
+					dyn_array->head = DYN_ARRAY_SLOT(dyn_array, dyn_array->capacity - count);
+				}
+				dyn_ring_copy_in(dyn_array, position, count, data_src);
+				dyn_array->size += count;
+				return true;
+			}
+			return false;
+		}
 		// may or may not need to increase capacity.
 		// We'll ask the capacity function if we can do it.
 		// If we can, do it. If not... Too bad for the user.
-		if (position <= dyn_array->size && dyn_request_size_increase(dyn_array, count)) 
+		if (position <= dyn_array->size && dyn_linearize(dyn_array) && dyn_request_size_increase(dyn_array, count)) 
 		{
 			if (position != dyn_array->size) 
 			{  // wasn't a gap at the end, we need to move data
@@ -379,8 +1037,46 @@ bool dyn_shift_remove(dyn_array_t *const dyn_array, const size_t position, const
 					  const DYN_SHIFT_MODE mode, void *const data_dst) 
 {
 	if (dyn_array && count && dyn_array->size && MODE_IS_TYPE(mode, TYPE_REMOVE)  // mode = MODE_EXTRACT || MODE_ERASE
-		&& (position + count) <= dyn_array->size)   // verify size and range
+		&& (position + count) <= dyn_array->size   // verify size and range
+		&& !DYN_IS_VIEW(dyn_array))                 // views are read-only
 { 
+		// Rings remove from either end by moving head or size, nothing shifts
+		if (DYN_IS_RING(dyn_array) && (position == 0 || position + count == dyn_array->size)) 
+		{
+			if (mode == MODE_ERASE) 
+			{
+				if (dyn_array->destructor) 
+				{
+					for (size_t idx = position; idx < position + count; ++idx) 
+					{
+						dyn_array->destructor(DYN_ARRAY_LOGICAL_POSITION(dyn_array, idx));
+					}
+				}
+			} 
+			else if (data_dst) 
+			{
+				dyn_ring_copy_out(dyn_array, position, count, data_dst);
+			} 
+			else 
+			{
+				return false;  // Extract with no dest??
+			}
+			if (position == 0) 
+			{
+				dyn_array->head = DYN_ARRAY_SLOT(dyn_array, count);
+			}
+			dyn_array->size -= count;
+			if (dyn_array->size == 0) 
+			{
+				dyn_array->head = 0;
+			}
+			dyn_drain_shrink(dyn_array);
+			return true;
+		}
+		if (!dyn_linearize(dyn_array)) 
+		{
+			return false;
+		}
 
 		// shrinking in size
 		// nice and simple (?)
@@ -417,6 +1113,7 @@ bool dyn_shift_remove(dyn_array_t *const dyn_array, const size_t position, const
 		}
 		// decrease the size and return
 		dyn_array->size -= count;
+		dyn_drain_shrink(dyn_array);
 		return true;
 	}
 	return false;
@@ -439,28 +1136,372 @@ bool dyn_request_size_increase(dyn_array_t *const dyn_array, const size_t increm
 		// have to reallocate, is that even possible?
 		size_t needed_size = dyn_array->size + increment;
 
-		// INSERT SHRINK_TO_FIT CORRECTION HERE
-
 		if (needed_size <= DYN_MAX_CAPACITY) 
 		{
-			size_t new_capacity = dyn_array->capacity << 1;
+			size_t new_capacity = dyn_array->capacity;
+			// a shrunk array can be down to one object, don't crawl back up from there
+			if (dyn_array->flags & SHRUNK) 
+			{
+				new_capacity = new_capacity > DYN_MIN_CAPACITY ? new_capacity : DYN_MIN_CAPACITY;
+			}
 			while (new_capacity < needed_size) 
 			{
-				new_capacity <<= 1;
+				// split so huge capacities don't overflow the multiply, and always grow by at least one
+				size_t grown = new_capacity / 100 * dyn_array->growth_percent
+							   + new_capacity % 100 * dyn_array->growth_percent / 100;
+				new_capacity = grown > new_capacity ? grown : new_capacity + 1;
+			}
+			if (new_capacity > DYN_MAX_CAPACITY) 
+			{
+				new_capacity = DYN_MAX_CAPACITY;
 			}
 
 			// we can theoretically hold this, check if we can allocate that
-			// if (!MULTIPLY_MAY_OVERFLOW(new_capacity, dyn_array->data_size)) {
-			// we won't overflow, so we can at least REQUEST this change
-			void *new_array = realloc(dyn_array->array, new_capacity * dyn_array->data_size);
-			if (new_array) 
+			// (a failed grow leaves the array shrunk, so the next try still starts from the minimum)
+			if (!dyn_set_capacity(dyn_array, new_capacity)) 
 			{
-				// success! Wasn't that easy?
-				dyn_array->array	= new_array;
-				dyn_array->capacity = new_capacity;
-				return true;
+				return false;
 			}
+			dyn_array->flags &= ~SHRUNK;
+			return true;
 		}
 	}
 	return false;
 }
+
+bool dyn_set_capacity(dyn_array_t *const dyn_array, const size_t new_capacity) 
+{
+	const size_t old_capacity = dyn_array->capacity;
+	// cutting the end off means the contents have to be at the front first
+	if (new_capacity < old_capacity && dyn_array->head + dyn_array->size > new_capacity && !dyn_linearize(dyn_array)) 
+	{
+		return false;
+	}
+	void *new_array = dyn_array->allocator.realloc(dyn_array->allocator.context, dyn_array->array,
+												   DYN_SIZE_N_ELEMS(dyn_array, old_capacity),
+												   DYN_SIZE_N_ELEMS(dyn_array, new_capacity));
+	if (!new_array) 
+	{
+		return false;
+	}
+	// success! Wasn't that easy?
+	dyn_array->array = new_array;
+	// a wrapped ring has to be made whole again in the bigger buffer
+	if (dyn_array->head + dyn_array->size > old_capacity) 
+	{
+		const size_t wrapped = dyn_array->head + dyn_array->size - old_capacity;
+		const size_t tail	 = old_capacity - dyn_array->head;
+		if (wrapped <= new_capacity - old_capacity) 
+		{
+			// the wrapped prefix fits past the old end
+			// [C][D][A][B] -> [?][?][A][B][C][D][?][?]
+			memcpy(DYN_ARRAY_POSITION(dyn_array, old_capacity), dyn_array->array, DYN_SIZE_N_ELEMS(dyn_array, wrapped));
+		} 
+		else 
+		{
+			// it doesn't (growth under 2x), slide the tail up to the new end instead
+			// [C][D][E][A][B] -> [C][D][E][?][?][A][B]
+			memmove(DYN_ARRAY_POSITION(dyn_array, new_capacity - tail), DYN_ARRAY_POSITION(dyn_array, dyn_array->head),
+					DYN_SIZE_N_ELEMS(dyn_array, tail));
+			dyn_array->head = new_capacity - tail;
+		}
+	}
+	dyn_array->capacity = new_capacity;
+	return true;
+}
+
+
+
+
+// Allocators
+
+static void *dyn_malloc_alloc(void *context, const size_t size) 
+{
+	(void) context;
+	return malloc(size);
+}
+
+static void *dyn_malloc_realloc(void *context, void *ptr, const size_t old_size, const size_t new_size) 
+{
+	(void) context;
+	(void) old_size;
+	return realloc(ptr, new_size);
+}
+
+static void dyn_malloc_free(void *context, void *ptr, const size_t size) 
+{
+	(void) context;
+	(void) size;
+	free(ptr);
+}
+
+const dyn_allocator_t dyn_default_allocator = {dyn_malloc_alloc, dyn_malloc_realloc, dyn_malloc_free, NULL};
+
+
+// Huge pages
+// Everything at or over DYN_HUGEPAGE_MIN is its own mapping, rounded up to whole huge pages
+// so the sizes we're handed back on realloc/free tell us which kind of block it is
+
+#define DYN_HUGEPAGE_SIZE (((size_t) 2) << 20)
+#define DYN_HUGEPAGE_MIN (DYN_HUGEPAGE_SIZE >> 1)
+#define DYN_HUGEPAGE_ROUND(size) (((size) + DYN_HUGEPAGE_SIZE - 1) & ~(DYN_HUGEPAGE_SIZE - 1))
+// keeps the rounding (and the extra page for alignment) from overflowing
+#define DYN_HUGEPAGE_MAX (SIZE_MAX - 2 * DYN_HUGEPAGE_SIZE)
+
+static void dyn_hugepage_advise(void *const ptr, const size_t length) 
+{
+#ifdef MADV_HUGEPAGE
+	// it's only advice, if THP is off we still have an aligned mapping
+	madvise(ptr, length, MADV_HUGEPAGE);
+#else
+	(void) ptr;
+	(void) length;
+#endif
+}
+
+static void *dyn_hugepage_alloc(void *context, const size_t size) 
+{
+	(void) context;
+	if (size < DYN_HUGEPAGE_MIN) 
+	{
+		return malloc(size);
+	}
+	if (size > DYN_HUGEPAGE_MAX) 
+	{
+		return NULL;
+	}
+	// mmap only promises regular page alignment, so map one huge page extra and trim both ends
+	const size_t length = DYN_HUGEPAGE_ROUND(size);
+	uint8_t *raw = (uint8_t *) mmap(NULL, length + DYN_HUGEPAGE_SIZE, PROT_READ | PROT_WRITE,
+									MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+	if (raw == MAP_FAILED) 
+	{
+		return NULL;
+	}
+	uint8_t *aligned = (uint8_t *) (((uintptr_t) raw + DYN_HUGEPAGE_SIZE - 1) & ~(uintptr_t) (DYN_HUGEPAGE_SIZE - 1));
+	const size_t lead = (size_t) (aligned - raw);
+	if (lead) 
+	{
+		munmap(raw, lead);
+	}
+	if (lead < DYN_HUGEPAGE_SIZE) 
+	{
+		munmap(aligned + length, DYN_HUGEPAGE_SIZE - lead);
+	}
+	dyn_hugepage_advise(aligned, length);
+	return aligned;
+}
+
+static void dyn_hugepage_free(void *context, void *ptr, const size_t size) 
+{
+	(void) context;
+	if (size < DYN_HUGEPAGE_MIN) 
+	{
+		free(ptr);
+	} 
+	else if (ptr) 
+	{
+		munmap(ptr, DYN_HUGEPAGE_ROUND(size));
+	}
+}
+
+static void *dyn_hugepage_realloc(void *context, void *ptr, const size_t old_size, const size_t new_size) 
+{
+	if (!ptr) 
+	{
+		return dyn_hugepage_alloc(context, new_size);
+	}
+	if (old_size < DYN_HUGEPAGE_MIN && new_size < DYN_HUGEPAGE_MIN) 
+	{
+		return realloc(ptr, new_size);
+	}
+	if (old_size >= DYN_HUGEPAGE_MIN && new_size >= DYN_HUGEPAGE_MIN && new_size <= DYN_HUGEPAGE_MAX) 
+	{
+		const size_t old_length = DYN_HUGEPAGE_ROUND(old_size);
+		const size_t new_length = DYN_HUGEPAGE_ROUND(new_size);
+		if (old_length == new_length) 
+		{
+			return ptr;
+		}
+		// resizing in place keeps the alignment (shrinking always works, growing if the next pages are free)
+		if (mremap(ptr, old_length, new_length, 0) != MAP_FAILED) 
+		{
+			dyn_hugepage_advise(ptr, new_length);
+			return ptr;
+		}
+	}
+	// crossing the malloc line or out of room to grow, move it
+	void *moved = dyn_hugepage_alloc(context, new_size);
+	if (moved) 
+	{
+		memcpy(moved, ptr, old_size < new_size ? old_size : new_size);
+		dyn_hugepage_free(context, ptr, old_size);
+	}
+	return moved;
+}
+
+const dyn_allocator_t dyn_hugepage_allocator = {dyn_hugepage_alloc, dyn_hugepage_realloc, dyn_hugepage_free, NULL};
+
+
+// Bump arena
+// Blocks are chained newest first, the first block is the one being bumped through
+// Allocations over half a block get a block of their own, linked in behind the first one
+
+typedef struct dyn_arena_block 
+{
+	struct dyn_arena_block *next;
+} dyn_arena_block_t;
+
+#define DYN_ARENA_ALIGN _Alignof(max_align_t)
+#define DYN_ARENA_ROUND(size) (((size) + DYN_ARENA_ALIGN - 1) & ~(DYN_ARENA_ALIGN - 1))
+// the data starts after the header, still max aligned
+#define DYN_ARENA_HEADER DYN_ARENA_ROUND(sizeof(dyn_arena_block_t))
+#define DYN_ARENA_DEFAULT_BLOCK (((size_t) 1) << 20)
+#define DYN_ARENA_MAX (SIZE_MAX - DYN_ARENA_HEADER - DYN_ARENA_ALIGN)
+
+struct dyn_arena 
+{
+	size_t block_size;
+	dyn_arena_block_t *blocks;
+	uint8_t *next;  // bump pointer into the first block
+	uint8_t *end;
+	uint8_t *last;  // latest allocation, the only one that can be resized or given back in place
+};
+
+static dyn_arena_block_t *dyn_arena_new_block(const size_t size) 
+{
+	return (dyn_arena_block_t *) malloc(DYN_ARENA_HEADER + size);
+}
+
+static void dyn_arena_use_block(dyn_arena_t *const arena, dyn_arena_block_t *const block) 
+{
+	arena->blocks = block;
+	arena->next	  = (uint8_t *) block + DYN_ARENA_HEADER;
+	arena->end	  = arena->next + arena->block_size;
+	arena->last	  = NULL;
+}
+
+static void *dyn_arena_alloc(void *context, const size_t size) 
+{
+	dyn_arena_t *arena = (dyn_arena_t *) context;
+	if (size > DYN_ARENA_MAX) 
+	{
+		return NULL;
+	}
+	const size_t rounded = DYN_ARENA_ROUND(size);
+	if (rounded > (size_t) (arena->end - arena->next)) 
+	{
+		if (rounded > arena->block_size >> 1) 
+		{
+			// too big to be worth giving up on what's left of the current block
+			dyn_arena_block_t *block = dyn_arena_new_block(rounded);
+			if (!block) 
+			{
+				return NULL;
+			}
+			block->next			 = arena->blocks->next;
+			arena->blocks->next = block;
+			return (uint8_t *) block + DYN_ARENA_HEADER;
+		}
+		dyn_arena_block_t *block = dyn_arena_new_block(arena->block_size);
+		if (!block) 
+		{
+			return NULL;
+		}
+		block->next = arena->blocks;
+		dyn_arena_use_block(arena, block);
+	}
+	arena->last = arena->next;
+	arena->next += rounded;
+	return arena->last;
+}
+
+// true if ptr is the latest allocation and nothing came after it
+static bool dyn_arena_is_last(const dyn_arena_t *const arena, const void *const ptr, const size_t size) 
+{
+	return ptr && ptr == arena->last && arena->last + DYN_ARENA_ROUND(size) == arena->next;
+}
+
+static void dyn_arena_free(void *context, void *ptr, const size_t size) 
+{
+	dyn_arena_t *arena = (dyn_arena_t *) context;
+	// anything else waits for reset/destroy
+	if (dyn_arena_is_last(arena, ptr, size)) 
+	{
+		arena->next = arena->last;
+		arena->last = NULL;
+	}
+}
+
+static void *dyn_arena_realloc(void *context, void *ptr, const size_t old_size, const size_t new_size) 
+{
+	dyn_arena_t *arena = (dyn_arena_t *) context;
+	// a growing array that's the latest allocation just bumps further (the common case for a lone array)
+	if (dyn_arena_is_last(arena, ptr, old_size) && new_size <= DYN_ARENA_MAX
+		&& DYN_ARENA_ROUND(new_size) <= (size_t) (arena->end - arena->last)) 
+	{
+		arena->next = arena->last + DYN_ARENA_ROUND(new_size);
+		return ptr;
+	}
+	void *moved = dyn_arena_alloc(context, new_size);
+	if (moved && ptr) 
+	{
+		memcpy(moved, ptr, old_size < new_size ? old_size : new_size);
+	}
+	return moved;
+}
+
+dyn_arena_t *dyn_arena_create(const size_t block_size) 
+{
+	if (block_size > DYN_ARENA_MAX) 
+	{
+		return NULL;
+	}
+	dyn_arena_t *arena = (dyn_arena_t *) malloc(sizeof(dyn_arena_t));
+	if (arena) 
+	{
+		arena->block_size		 = block_size ? DYN_ARENA_ROUND(block_size) : DYN_ARENA_DEFAULT_BLOCK;
+		dyn_arena_block_t *block = dyn_arena_new_block(arena->block_size);
+		if (block) 
+		{
+			block->next = NULL;
+			dyn_arena_use_block(arena, block);
+			return arena;
+		}
+		free(arena);
+	}
+	return NULL;
+}
+
+dyn_allocator_t dyn_arena_allocator(dyn_arena_t *const arena) 
+{
+	dyn_allocator_t allocator = {dyn_arena_alloc, dyn_arena_realloc, dyn_arena_free, arena};
+	return allocator;
+}
+
+void dyn_arena_reset(dyn_arena_t *const arena) 
+{
+	if (arena) 
+	{
+		// the first block is always a regular sized one, keep it for the next batch
+		dyn_arena_block_t *block = arena->blocks->next;
+		while (block) 
+		{
+			dyn_arena_block_t *next = block->next;
+			free(block);
+			block = next;
+		}
+		arena->blocks->next = NULL;
+		dyn_arena_use_block(arena, arena->blocks);
+	}
+}
+
+void dyn_arena_destroy(dyn_arena_t *const arena) 
+{
+	if (arena) 
+	{
+		dyn_arena_reset(arena);
+		free(arena->blocks);
+		free(arena);
+	}
+}
@@ -0,0 +1,334 @@
+#define _GNU_SOURCE
+#include <getopt.h>
+#include <inttypes.h>
+#include <math.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "processing_scheduling.h"
+
+// Writes synthetic pcb files in the format load_process_control_blocks reads:
+// a uint32 count followed by count {burst, priority, arrival} uint32 triples
+// Records are generated and written a chunk at a time so any size file takes the same memory
+
+// records buffered per write
+#define GEN_CHUNK 4096
+// most priority levels a skewed distribution can have, its cdf is kept in memory
+#define MAX_PRIORITY_LEVELS 65536
+
+typedef enum { BURST_EXP, BURST_PARETO, BURST_UNIFORM } BURST_DIST;
+typedef enum { ARRIVAL_POISSON, ARRIVAL_BURSTY } ARRIVAL_DIST;
+typedef enum { PRIORITY_UNIFORM, PRIORITY_ZIPF } PRIORITY_DIST;
+
+typedef struct
+{
+    BURST_DIST burst;
+    double burst_a;  // exp: mean, pareto: alpha, uniform: min
+    double burst_b;  // pareto: min, uniform: max
+    ARRIVAL_DIST arrival;
+    double mean_gap;   // mean time between arrivals
+    double mean_batch; // bursty: mean number of pcbs arriving together
+    PRIORITY_DIST priority;
+    uint32_t levels;   // priorities are 0..levels-1
+    double skew;       // zipf exponent
+    uint64_t seed;
+} generator_config_t;
+
+// splitmix64
+static uint64_t next_random(uint64_t *state)
+{
+    uint64_t z = (*state += 0x9E3779B97F4A7C15ULL);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+
+// uniform in (0, 1]
+static double next_unit(uint64_t *state)
+{
+    return ((next_random(state) >> 11) + 1) * (1.0 / 9007199254740992.0);
+}
+
+static double next_exponential(uint64_t *state, double mean)
+{
+    return -mean * log(next_unit(state));
+}
+
+// geometric on 1, 2, ... with the given mean (>= 1)
+static double next_geometric(uint64_t *state, double mean)
+{
+    if (mean <= 1.0)
+    {
+        return 1.0;
+    }
+    // the number of trials up to the first success with p = 1 / mean
+    return 1.0 + floor(log(next_unit(state)) / log(1.0 - 1.0 / mean));
+}
+
+// clamps a sampled time into a uint32 field
+static uint32_t to_u32(double value)
+{
+    return value >= (double)UINT32_MAX ? UINT32_MAX : (uint32_t)value;
+}
+
+static uint32_t sample_burst(const generator_config_t *config, uint64_t *state)
+{
+    double burst;
+    switch (config->burst)
+    {
+    case BURST_EXP:
+        burst = next_exponential(state, config->burst_a);
+        break;
+    case BURST_PARETO:
+        burst = config->burst_b / pow(next_unit(state), 1.0 / config->burst_a);
+        break;
+    default:
+        burst = config->burst_a + (double)(next_random(state) % (uint64_t)(config->burst_b - config->burst_a + 1));
+        break;
+    }
+    // every process needs at least one tick
+    return burst < 1.0 ? 1 : to_u32(burst);
+}
+
+static uint32_t sample_priority(const generator_config_t *config, const double *cdf, uint64_t *state)
+{
+    if (config->priority == PRIORITY_UNIFORM)
+    {
+        return (uint32_t)(next_random(state) % config->levels);
+    }
+    // first level whose cdf covers the draw, level 0 is the most likely
+    double draw = next_unit(state);
+    uint32_t low = 0, high = config->levels - 1;
+    while (low < high)
+    {
+        uint32_t mid = low + (high - low) / 2;
+        if (cdf[mid] < draw)
+        {
+            low = mid + 1;
+        }
+        else
+        {
+            high = mid;
+        }
+    }
+    return low;
+}
+
+// Parses NAME:a[:b] into its parts, returns how many numbers were found
+static int parse_dist(const char *spec, char *name, size_t name_size, double *a, double *b)
+{
+    const char *colon = strchr(spec, ':');
+    size_t length = colon ? (size_t)(colon - spec) : strlen(spec);
+    if (length >= name_size)
+    {
+        return -1;
+    }
+    memcpy(name, spec, length);
+    name[length] = '\0';
+    return colon ? sscanf(colon + 1, "%lf:%lf", a, b) : 0;
+}
+
+static void usage(const char *program)
+{
+    printf("%s <count> <output file, - for stdout> [options]\n"
+           "  --burst exp:MEAN | pareto:ALPHA:MIN | uniform:MIN:MAX   (default exp:50)\n"
+           "  --arrival poisson:MEAN_GAP | bursty:MEAN_GAP:MEAN_BATCH  (default poisson:55)\n"
+           "  --priority uniform:LEVELS | zipf:LEVELS:SKEW            (default uniform:16)\n"
+           "  --seed N                                               (default 520)\n",
+           program);
+}
+
+static bool parse_options(int argc, char **argv, generator_config_t *config)
+{
+    static const struct option options[] = {
+        {"burst", required_argument, NULL, 'b'},
+        {"arrival", required_argument, NULL, 'a'},
+        {"priority", required_argument, NULL, 'p'},
+        {"seed", required_argument, NULL, 's'},
+        {NULL, 0, NULL, 0},
+    };
+    int option;
+    while ((option = getopt_long(argc, argv, "b:a:p:s:", options, NULL)) != -1)
+    {
+        char name[16] = "";
+        double a = 0, b = 0;
+        int numbers = option == 's' ? 0 : parse_dist(optarg, name, sizeof(name), &a, &b);
+        switch (option)
+        {
+        case 'b':
+            if (strcmp(name, "exp") == 0 && numbers >= 1 && a > 0)
+            {
+                config->burst = BURST_EXP;
+                config->burst_a = a;
+            }
+            else if (strcmp(name, "pareto") == 0 && numbers == 2 && a > 0 && b > 0)
+            {
+                config->burst = BURST_PARETO;
+                config->burst_a = a;
+                config->burst_b = b;
+            }
+            else if (strcmp(name, "uniform") == 0 && numbers == 2 && a >= 0 && b >= a && b <= UINT32_MAX)
+            {
+                config->burst = BURST_UNIFORM;
+                config->burst_a = a;
+                config->burst_b = b;
+            }
+            else
+            {
+                fprintf(stderr, "Invalid burst distribution: %s\n", optarg);
+                return false;
+            }
+            break;
+        case 'a':
+            if (strcmp(name, "poisson") == 0 && numbers >= 1 && a >= 0)
+            {
+                config->arrival = ARRIVAL_POISSON;
+                config->mean_gap = a;
+            }
+            else if (strcmp(name, "bursty") == 0 && numbers == 2 && a >= 0 && b >= 1)
+            {
+                config->arrival = ARRIVAL_BURSTY;
+                config->mean_gap = a;
+                config->mean_batch = b;
+            }
+            else
+            {
+                fprintf(stderr, "Invalid arrival distribution: %s\n", optarg);
+                return false;
+            }
+            break;
+        case 'p':
+            if (strcmp(name, "uniform") == 0 && numbers >= 1 && a >= 1 && a <= UINT32_MAX)
+            {
+                config->priority = PRIORITY_UNIFORM;
+                config->levels = (uint32_t)a;
+            }
+            else if (strcmp(name, "zipf") == 0 && numbers == 2 && a >= 1 && a <= MAX_PRIORITY_LEVELS && b >= 0)
+            {
+                config->priority = PRIORITY_ZIPF;
+                config->levels = (uint32_t)a;
+                config->skew = b;
+            }
+            else
+            {
+                fprintf(stderr, "Invalid priority distribution: %s\n", optarg);
+                return false;
+            }
+            break;
+        case 's':
+            if (sscanf(optarg, "%" SCNu64, &config->seed) != 1)
+            {
+                fprintf(stderr, "Invalid seed: %s\n", optarg);
+                return false;
+            }
+            break;
+        default:
+            return false;
+        }
+    }
+    return true;
+}
+
+int main(int argc, char **argv)
+{
+    generator_config_t config = {BURST_EXP, 50, 0, ARRIVAL_POISSON, 55, 1, PRIORITY_UNIFORM, 16, 0, 520};
+    if (!parse_options(argc, argv, &config) || argc - optind != 2)
+    {
+        usage(argv[0]);
+        return EXIT_FAILURE;
+    }
+    uint32_t count;
+    if (sscanf(argv[optind], "%u", &count) != 1 || count == 0)
+    {
+        fprintf(stderr, "Invalid count: %s\n", argv[optind]);
+        return EXIT_FAILURE;
+    }
+    const char *output = argv[optind + 1];
+
+    // zipf levels get a cdf once up front, it only depends on the level count
+    double *cdf = NULL;
+    if (config.priority == PRIORITY_ZIPF)
+    {
+        cdf = (double *)malloc(sizeof(double) * config.levels);
+        if (!cdf)
+        {
+            fprintf(stderr, "%s:%d failed cdf malloc\n", __FILE__, __LINE__);
+            return EXIT_FAILURE;
+        }
+        double total = 0;
+        for (uint32_t level = 0; level < config.levels; ++level)
+        {
+            total += 1.0 / pow(level + 1, config.skew);
+            cdf[level] = total;
+        }
+        for (uint32_t level = 0; level < config.levels; ++level)
+        {
+            cdf[level] /= total;
+        }
+    }
+
+    FILE *file = strcmp(output, "-") == 0 ? stdout : fopen(output, "wb");
+    if (!file)
+    {
+        fprintf(stderr, "%s:%d error opening %s\n", __FILE__, __LINE__, output);
+        free(cdf);
+        return EXIT_FAILURE;
+    }
+
+    ProcessControlRecord_t *chunk = (ProcessControlRecord_t *)malloc(sizeof(ProcessControlRecord_t) * GEN_CHUNK);
+    bool ok = chunk && fwrite(&count, sizeof(uint32_t), 1, file) == 1;
+
+    uint64_t state = config.seed;
+    double arrival = 0;
+    // bursty arrivals come in batches, this is how many are left in the current one
+    double batch_left = config.arrival == ARRIVAL_BURSTY ? next_geometric(&state, config.mean_batch) : 0;
+    bool saturated = false;
+    for (uint32_t written = 0; ok && written < count;)
+    {
+        size_t fill = count - written < GEN_CHUNK ? count - written : GEN_CHUNK;
+        for (size_t i = 0; i < fill; ++i)
+        {
+            chunk[i].burst_time = sample_burst(&config, &state);
+            chunk[i].priority = sample_priority(&config, cdf, &state);
+            chunk[i].arrival = to_u32(arrival);
+            saturated = saturated || arrival >= (double)UINT32_MAX;
+
+            if (config.arrival == ARRIVAL_POISSON)
+            {
+                arrival += next_exponential(&state, config.mean_gap);
+            }
+            else if (--batch_left <= 0)
+            {
+                // batch sizes average mean_batch, so a mean_gap * mean_batch gap between batches
+                // keeps the overall rate at 1 / mean_gap
+                batch_left = next_geometric(&state, config.mean_batch);
+                arrival += next_exponential(&state, config.mean_gap * config.mean_batch);
+            }
+        }
+        ok = fwrite(chunk, sizeof(ProcessControlRecord_t), fill, file) == fill;
+        written += (uint32_t)fill;
+    }
+
+    if (saturated)
+    {
+        fprintf(stderr, "arrival times passed the uint32 range and were clamped, use a smaller mean gap\n");
+    }
+    if (file != stdout)
+    {
+        ok = fclose(file) == 0 && ok;
+    }
+    else
+    {
+        ok = fflush(stdout) == 0 && ok;
+    }
+    free(chunk);
+    free(cdf);
+    if (!ok)
+    {
+        fprintf(stderr, "%s:%d error writing %s\n", __FILE__, __LINE__, output);
+        return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+}
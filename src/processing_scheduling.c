@@ -1,6 +1,10 @@
+#define _GNU_SOURCE
+#include <errno.h>
 #include <fcntl.h>
 #include <stdio.h>
 #include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
 #include <unistd.h>
 
 #include "dyn_array.h"
@@ -38,6 +42,9 @@ int arrival_time_compare(const void *a, const void *b)
     return (pcb1->arrival < pcb2->arrival) ? -1 : (pcb1->arrival > pcb2->arrival);
 }
 
+// The schedulers are instantiated from include/scheduler_engine.hpp in src/scheduler_engine.cpp,
+// this file keeps the comparators and the pcb loaders
+
 // private function
 void virtual_cpu(ProcessControlBlock_t *process_control_block)
 {
@@ -45,500 +52,424 @@ void virtual_cpu(ProcessControlBlock_t *process_control_block)
     --process_control_block->remaining_burst_time;
 }
 
-// Runs the First Come First Served Process Scheduling algorithm over the incoming ready_queue
-// \param ready queue a dyn_array of type ProcessControlBlock_t that contain be up to N elements
-// \param result used for first come first served stat tracking \ref ScheduleResult_t
-// \return true if function ran successful else false for an error
-bool first_come_first_serve(dyn_array_t *ready_queue, ScheduleResult_t *result)
+// reads exactly count bytes, retrying short reads
+// \return false on error or end of file
+static bool read_fully(int fd, void *buffer, size_t count)
 {
-    // Validate inputs
-    if (!ready_queue || !result)
+    uint8_t *dst = (uint8_t *)buffer;
+    while (count)
     {
-        fprintf(stderr, "%s:%d invalid parameter\n", __FILE__, __LINE__);
-        return false; // Return false for null input
+        ssize_t got = read(fd, dst, count);
+        if (got < 0 && errno == EINTR)
+        {
+            continue;
+        }
+        if (got <= 0)
+        {
+            return false;
+        }
+        dst += got;
+        count -= (size_t)got;
     }
+    return true;
+}
+
+// opens a pcb file for reading, "-" means stdin
+static int open_pcb_input(const char *input_file)
+{
+    return strcmp(input_file, "-") == 0 ? STDIN_FILENO : open(input_file, O_RDONLY);
+}
 
-    // check if the queue is empty and handle case
-    if (dyn_array_size(ready_queue) == 0)
+// stdin is not ours to close
+static void close_pcb_input(int fd)
+{
+    if (fd != STDIN_FILENO)
     {
-        result->average_waiting_time = 0.0f;
-        result->average_turnaround_time = 0.0f;
-        result->total_run_time = 0UL;
-        return true; // Success with zeroed results
+        close(fd);
     }
+}
 
-    // Sort the array by arrival time and check if it failed
-    if (!dyn_array_sort(ready_queue, arrival_time_compare))
+///*
+// preston's load_process_control_blocks
+// Reads the PCB burst time values from the binary file into ProcessControlBlock_t remaining_burst_time field
+// for N number of PCB burst time stored in the file.
+// \param input_file the file containing the PCB burst times
+// \return a populated dyn_array of ProcessControlBlocks if function ran successful else NULL for an error
+dyn_array_t *load_process_control_blocks(const char *input_file)
+{
+    // check invaild parametes
+    if (input_file == NULL)
     {
-        fprintf(stderr, "Failed to sort ready queue by arrival time\n");
-        return false;
+        fprintf(stderr, "%s:%d invalid parameter\n", __FILE__, __LINE__);
+        return NULL;
     }
 
-    /*
-    // check to make sure values are sorted
-    printf("Sorted Processes (Arrival Time, Burst Time):\n");
-    for (size_t i = 0; i < dyn_array_size(ready_queue); ++i) {
-        ProcessControlBlock_t *pc = dyn_array_at(ready_queue, i);
-        if (pc) {
-            printf("Process %zu: Arrival = %u, Burst = %u\n", i, pc->arrival, pc->remaining_burst_time);
-        }
+    int fd = open_pcb_input(input_file);
+    // make sure the file opens
+    if (fd < 0)
+    {
+        fprintf(stderr, "%s:%d error opening file\n", __FILE__, __LINE__);
+        return NULL;
     }
-    //*/
-    // Initialize statistics
-    unsigned long total_run_time = 0;
-    float total_wait_time = 0;
-    float total_turnaround_time = 0;
 
-    // Iterate over all processes in the ready_queue
-    // use current_time to track when CPU is available for the next process
-    uint32_t current_time = 0;
-
-    // look at each item in the queue
-    for (size_t i = 0; i < dyn_array_size(ready_queue); ++i)
+    // read the pcb count
+    uint32_t pcb_count;
+    if (!read_fully(fd, &pcb_count, sizeof(uint32_t)))
     {
-        // convert the item in array to control block
-        ProcessControlBlock_t *pc = dyn_array_at(ready_queue, i);
-        // check if conversion worked
-        if (!pc)
-        {
-            fprintf(stderr, "%s:%d process control block is null\n", __FILE__, __LINE__);
-            return false; // If PCB is NULL, return false
-        }
-
-        // Calculate wait time
-        uint32_t wait_time;
-        // when the current time reached the arrival begin counting
-        if (current_time >= pc->arrival)
-        {
-            wait_time = current_time - pc->arrival;
-        }
-        // befire process begins
-        else
-        {
-            wait_time = 0;
-        }
-        // Calculate turnaround time
-        uint32_t turnaround_time = wait_time + pc->remaining_burst_time;
-
-        // return value of process
-        // printf("Process %zu: Wait Time = %u, Turnaround Time = %u\n", i, wait_time, turnaround_time);
-
-        // Update the statistics
-        total_wait_time += wait_time;
-        total_turnaround_time += turnaround_time;
-        total_run_time += pc->remaining_burst_time;
+        fprintf(stderr, "%s:%d error reading PCB count\n", __FILE__, __LINE__);
+        close_pcb_input(fd);
+        return NULL;
+    }
 
-        // Update the current time with when this process finishes
-        current_time += pc->remaining_burst_time;
+    // Validate file size once before allocating anything (only regular files know their size)
+    struct stat file_stat;
+    if (pcb_count == 0 || fstat(fd, &file_stat) != 0
+        || (S_ISREG(file_stat.st_mode)
+            && ((size_t)file_stat.st_size - sizeof(uint32_t)) / sizeof(ProcessControlRecord_t) < pcb_count))
+    {
+        fprintf(stderr, "%s:%d invalid PCB count: %u\n", __FILE__, __LINE__, pcb_count);
+        close_pcb_input(fd);
+        return NULL;
     }
 
-    // Calculate averages
-    result->average_waiting_time = total_wait_time / dyn_array_size(ready_queue);
-    result->average_turnaround_time = total_turnaround_time / dyn_array_size(ready_queue);
-    result->total_run_time = total_run_time;
+    // One allocation sized for the widened blocks, the records are read into the front of it
+    ProcessControlBlock_t *pc = (ProcessControlBlock_t *)malloc(sizeof(ProcessControlBlock_t) * pcb_count);
+    // check if load fails
+    if (!pc)
+    {
+        fprintf(stderr, "%s:%d error allocating memory\n", __FILE__, __LINE__);
+        close_pcb_input(fd);
+        return NULL;
+    }
+    if (!read_fully(fd, pc, sizeof(ProcessControlRecord_t) * pcb_count))
+    {
+        fprintf(stderr, "%s:%d error reading PCBs\n", __FILE__, __LINE__);
+        free(pc);
+        close_pcb_input(fd);
+        return NULL;
+    }
+    // handle the file
+    close_pcb_input(fd);
 
-    // Print the final results
-    // printf("Total Waiting Time = %.2f, Total Turnaround Time = %.2f, Total Run Time = %lu\n", total_wait_time, total_turnaround_time, total_run_time);
-    // printf("Average Waiting Time = %.2f, Average Turnaround Time = %.2f\n", result->average_waiting_time, result->average_turnaround_time);
+    // Widen 12 byte records into 16 byte blocks back to front
+    // block i starts at or after the end of record i - 1, so no unread record is overwritten
+    const ProcessControlRecord_t *records = (const ProcessControlRecord_t *)pc;
+    for (size_t i = pcb_count; i-- > 0;)
+    {
+        ProcessControlRecord_t record = records[i];
+        pc[i].remaining_burst_time = record.burst_time;
+        pc[i].priority = record.priority;
+        pc[i].arrival = record.arrival;
+        pc[i].started = false;
+    }
 
-    return true; // Success
+    // hand the buffer over to a new dynamic array
+    dyn_array_t *dyn_array = dyn_array_adopt(pc, pcb_count, sizeof(ProcessControlBlock_t), NULL);
+    // check for failed dynamic array
+    if (!dyn_array)
+    {
+        fprintf(stderr, "%s:%d error creating dynamic array\n", __FILE__, __LINE__);
+        free(pc);
+        return NULL;
+    }
+    return dyn_array;
 }
 
-///*
-// Runs the Shortest Job First Scheduling algorithm over the incoming ready_queue
-// \param ready queue a dyn_array of type ProcessControlBlock_t that contain be up to N elements
-// \param result used for shortest job first stat tracking \ref ScheduleResult_t
-// \return true if function ran successful else false for an error
-bool shortest_job_first(dyn_array_t *ready_queue, ScheduleResult_t *result)
+bool open_process_control_stream(const char *input_file, PcbStream_t *stream)
 {
-    // Validate inputs
-    if (!ready_queue || !result)
+    // check invaild parametes
+    if (input_file == NULL || stream == NULL)
     {
-        fprintf(stderr, "%s:%d invalid parameters\n", __FILE__, __LINE__);
+        fprintf(stderr, "%s:%d invalid parameter\n", __FILE__, __LINE__);
         return false;
     }
 
-    // Get the size of the ready queue
-    size_t n = dyn_array_size(ready_queue);
-    
-    // Check for empty queue
-    if (n == 0)
+    stream->fd = open_pcb_input(input_file);
+    if (stream->fd < 0)
     {
-        // If the queue is empty, zero out the results
-        result->average_waiting_time = 0.0f;
-        result->average_turnaround_time = 0.0f;
-        result->total_run_time = 0UL;
-        return true;
+        fprintf(stderr, "%s:%d error opening file\n", __FILE__, __LINE__);
+        return false;
     }
-
-    // Sort the ready queue by burst time and then by arrival time
-    if (!dyn_array_sort(ready_queue, sjf_compare))
+    // the header is all we can check, the records are validated as they are read
+    if (!read_fully(stream->fd, &stream->remaining, sizeof(uint32_t)) || stream->remaining == 0)
     {
-        fprintf(stderr, "Failed to sort ready queue\n");
+        fprintf(stderr, "%s:%d error reading PCB count\n", __FILE__, __LINE__);
+        close_pcb_input(stream->fd);
         return false;
     }
+    stream->count = 0;
+    return true;
+}
 
-    // Initialize statistics
-    unsigned long total_wait_time = 0;
-    unsigned long total_turnaround_time = 0;
-    unsigned long total_run_time = 0;
-    uint32_t current_time = 0;
-
-    // Iterate over the sorted processes
-    for (size_t i = 0; i < n; ++i)
+bool read_process_control_chunk(PcbStream_t *stream)
+{
+    stream->count = 0;
+    if (!stream->remaining)
     {
-        // Convert and check for failed conversion
-        ProcessControlBlock_t *pcb = (ProcessControlBlock_t *)dyn_array_at(ready_queue, i);
-        if (!pcb)
-        {
-            fprintf(stderr, "Process Control Block is NULL\n");
-            return false;
-        }
-
-        // If the current time is less than the arrival time, CPU is idle until the process arrives
-        if (current_time < pcb->arrival)
-        {
-            current_time = pcb->arrival;
-        }
-
-        // Calculate wait time and turnaround time
-        uint32_t wait_time = current_time - pcb->arrival;
-        uint32_t turnaround_time = wait_time + pcb->remaining_burst_time;
-
-        // Update statistics
-        total_wait_time += wait_time;
-        total_turnaround_time += turnaround_time;
-        total_run_time += pcb->remaining_burst_time;  // Fix: Increment total_run_time by burst time
-
-        // Move current time forward
-        current_time += pcb->remaining_burst_time;
+        return false;
     }
-
-    // Calculate averages
-    result->average_waiting_time = (float)total_wait_time / n;
-    result->average_turnaround_time = (float)total_turnaround_time / n;
-    result->total_run_time = total_run_time;
-
+    size_t want = stream->remaining < PCB_STREAM_CHUNK ? stream->remaining : PCB_STREAM_CHUNK;
+    if (!read_fully(stream->fd, stream->chunk, sizeof(ProcessControlRecord_t) * want))
+    {
+        fprintf(stderr, "%s:%d error reading PCBs\n", __FILE__, __LINE__);
+        return false;
+    }
+    stream->count = want;
+    stream->remaining -= want;
     return true;
 }
-//*/
-///*
-// Runs the Priority algorithm over the incoming ready_queue
-// \param ready queue a dyn_array of type ProcessControlBlock_t that contain be up to N elements
-// \param result used for shortest job first stat tracking \ref ScheduleResult_t
-// \return true if function ran successful else false for an error
-bool priority(dyn_array_t *ready_queue, ScheduleResult_t *result)
+
+void close_process_control_stream(PcbStream_t *stream)
 {
-    // Validate input parameters
-    if (!ready_queue || !result)
+    if (stream)
     {
-        fprintf(stderr, "Error: NULL ready_queue or result\n");
-        return false;
+        close_pcb_input(stream->fd);
+        stream->fd = -1;
     }
+}
 
-    size_t n = dyn_array_size(ready_queue);
-    if (n == 0)
+bool map_process_control_blocks(const char *input_file, PcbFileMap_t *map)
+{
+    // check invaild parametes
+    if (input_file == NULL || map == NULL)
     {
-        // If no processes, set results to zero
-        result->average_waiting_time = 0.0f;
-        result->average_turnaround_time = 0.0f;
-        result->total_run_time = 0UL;
-        return true;
+        fprintf(stderr, "%s:%d invalid parameter\n", __FILE__, __LINE__);
+        return false;
     }
 
-    // Sort the ready queue by priority (ascending) and arrival time (ascending)
-    if (!dyn_array_sort(ready_queue, priority_compare))
+    int fd = open(input_file, O_RDONLY);
+    // make sure the file opens
+    if (fd < 0)
     {
-        fprintf(stderr, "Error: Failed to sort ready queue\n");
+        fprintf(stderr, "%s:%d error opening file\n", __FILE__, __LINE__);
         return false;
     }
 
-    unsigned long total_wait_time = 0;
-    unsigned long total_turnaround_time = 0;
-    unsigned long total_run_time = 0;
-    uint32_t current_time = 0;
-
-    // Iterate through sorted queue
-    for (size_t i = 0; i < n; ++i)
+    // Validate file size before reading pcb_count
+    struct stat file_stat;
+    if (fstat(fd, &file_stat) != 0 || (size_t)file_stat.st_size < sizeof(uint32_t))
     {
-        ProcessControlBlock_t *pcb = (ProcessControlBlock_t *)dyn_array_at(ready_queue, i);
-        if (!pcb)
-        {
-            fprintf(stderr, "Error: NULL PCB encountered\n");
-            return false;
-        }
-
-        // If CPU is idle, move to arrival time
-        if (current_time < pcb->arrival)
-        {
-            current_time = pcb->arrival;
-        }
-
-        // Compute wait time and turnaround time
-        uint32_t wait_time = current_time - pcb->arrival;
-        uint32_t turnaround_time = wait_time + pcb->remaining_burst_time;
-
-        // Update statistics
-        total_wait_time += wait_time;
-        total_turnaround_time += turnaround_time;
-        total_run_time = current_time + pcb->remaining_burst_time;
+        fprintf(stderr, "%s:%d file too small to contain PCB count\n", __FILE__, __LINE__);
+        close(fd);
+        return false;
+    }
+    size_t file_size = (size_t)file_stat.st_size;
 
-        // Move current time forward
-        current_time += pcb->remaining_burst_time;
+    void *mapping = mmap(NULL, file_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    // the mapping keeps its own reference to the file
+    close(fd);
+    if (mapping == MAP_FAILED)
+    {
+        fprintf(stderr, "%s:%d error mapping file\n", __FILE__, __LINE__);
+        return false;
     }
+    // records are walked front to back
+    madvise(mapping, file_size, MADV_SEQUENTIAL);
 
-    // Compute averages
-    result->average_waiting_time = (float)total_wait_time / n;
-    result->average_turnaround_time = (float)total_turnaround_time / n;
-    result->total_run_time = total_run_time;
+    // read the pcb count and check the records are all there
+    uint32_t pcb_count;
+    memcpy(&pcb_count, mapping, sizeof(uint32_t));
+    if (pcb_count == 0 || (file_size - sizeof(uint32_t)) / sizeof(ProcessControlRecord_t) < pcb_count)
+    {
+        fprintf(stderr, "%s:%d invalid PCB count: %u\n", __FILE__, __LINE__, pcb_count);
+        munmap(mapping, file_size);
+        return false;
+    }
 
+    // the records start right after the count, which keeps them 4 byte aligned
+    map->records = dyn_array_create_view((uint8_t *)mapping + sizeof(uint32_t), pcb_count, sizeof(ProcessControlRecord_t));
+    if (!map->records)
+    {
+        fprintf(stderr, "%s:%d error creating dynamic array\n", __FILE__, __LINE__);
+        munmap(mapping, file_size);
+        return false;
+    }
+    map->mapping = mapping;
+    map->mapping_size = file_size;
     return true;
 }
 
-bool round_robin(dyn_array_t *ready_queue, ScheduleResult_t *result, size_t quantum)
+void unmap_process_control_blocks(PcbFileMap_t *map)
 {
-    if (!ready_queue || !result || quantum == 0 || dyn_array_size(ready_queue) == 0)
+    if (map && map->mapping)
     {
-        return false;
+        dyn_array_destroy(map->records);
+        munmap(map->mapping, map->mapping_size);
+        map->records = NULL;
+        map->mapping = NULL;
+        map->mapping_size = 0;
     }
+}
+
+// pcbs converted per bulk push in process_control_blocks_from_records
+#define PCB_CONVERT_CHUNK 256
 
-    if (!dyn_array_sort(ready_queue, arrival_time_compare))
+dyn_array_t *process_control_blocks_from_records(const dyn_array_t *records)
+{
+    if (!records || dyn_array_data_size(records) != sizeof(ProcessControlRecord_t))
     {
-        fprintf(stderr, "Error: Failed to sort ready queue\n");
-        return false;
+        fprintf(stderr, "%s:%d invalid parameter\n", __FILE__, __LINE__);
+        return NULL;
     }
 
-    float total_waiting_time = 0.0;
-    float total_turnaround_time = 0.0;
-    unsigned long total_run_time = 0;
-    unsigned long current_time = 0;
-    size_t num_processes = dyn_array_size(ready_queue);
-
-    while (dyn_array_size(ready_queue) > 0)
+    size_t pcb_count = dyn_array_size(records);
+    dyn_array_t *dyn_array = dyn_array_create(pcb_count, sizeof(ProcessControlBlock_t), NULL);
+    if (!dyn_array)
     {
-        ProcessControlBlock_t *current_process = dyn_array_at(ready_queue, 0);
-        if (!current_process)
-        {
-            return false; // Error: process is NULL
-        }
+        fprintf(stderr, "%s:%d error creating dynamic array\n", __FILE__, __LINE__);
+        return NULL;
+    }
 
-        // If CPU is idle, move to the arrival time
-        if (current_time < current_process->arrival)
+    // converted a chunk at a time and pushed in bulk, capacity was reserved up front so this never reallocates
+    const ProcessControlRecord_t *record = (const ProcessControlRecord_t *)dyn_array_export(records);
+    ProcessControlBlock_t chunk[PCB_CONVERT_CHUNK];
+    for (size_t done = 0; done < pcb_count;)
+    {
+        size_t count = pcb_count - done < PCB_CONVERT_CHUNK ? pcb_count - done : PCB_CONVERT_CHUNK;
+        for (size_t i = 0; i < count; ++i, ++record)
         {
-            current_time = current_process->arrival;
+            ProcessControlBlock_t pcb = {record->burst_time, record->priority, record->arrival, false};
+            chunk[i] = pcb;
         }
+        dyn_array_push_back_n(dyn_array, chunk, count);
+        done += count;
+    }
+    return dyn_array;
+}
 
-        // Calculate wait time: current time - arrival time
-        unsigned long wait_time = current_time - current_process->arrival;
+// bytes taken by one array of count uint32 fields, padded so the next array stays aligned
+static size_t soa_array_bytes(size_t count)
+{
+    size_t bytes = count * sizeof(uint32_t);
+    return (bytes + PCB_SOA_ALIGNMENT - 1) / PCB_SOA_ALIGNMENT * PCB_SOA_ALIGNMENT;
+}
 
-        if (current_process->remaining_burst_time <= quantum) // complete the process
-        {
-            while (current_process->remaining_burst_time > 0)
-            {
-                current_process->started = true;
-                virtual_cpu(current_process); // Decrement the remaining burst time
-                current_time++;               // Increment the time for each execution cycle
-            }
-            // After the process finishes, calculate turnaround time
-            unsigned long turnaround_time = current_time - current_process->arrival;
-            total_turnaround_time += turnaround_time;
-            total_waiting_time += wait_time;
-            total_run_time += turnaround_time; // Run time is typically the turnaround time
-            dyn_array_pop_front(ready_queue);  // Remove process from ready queue
-        }
-        else // run the process up to the quantum
-        {
-            for (size_t i = 0; i < quantum; i++)
-            {
-                current_process->started = true;
-                virtual_cpu(current_process); // Decrement the remaining burst time
-                current_time++;               // Increment the time for each execution cycle
-                total_waiting_time--;
-            }
-            // Re-insert the process into the ready queue if not finished
-            dyn_array_push_back(ready_queue, current_process);
-            dyn_array_pop_front(ready_queue);
-        }
+bool pcb_soa_create(size_t count, PcbSoA_t *soa)
+{
+    // pcbs are ordered through uint32 indices
+    if (!soa || count == 0 || count > UINT32_MAX)
+    {
+        fprintf(stderr, "%s:%d invalid parameter\n", __FILE__, __LINE__);
+        return false;
     }
 
-    // Store the results
-    result->average_waiting_time = total_waiting_time / num_processes;
-    result->average_turnaround_time = total_turnaround_time / num_processes;
-    result->total_run_time = total_run_time;
-
+    // burst, priority and arrival arrays then the started bitset, all in one aligned block
+    size_t array_bytes = soa_array_bytes(count);
+    size_t bitset_bytes = (count + 63) / 64 * sizeof(uint64_t);
+    size_t block_bytes = 3 * array_bytes + bitset_bytes;
+    block_bytes = (block_bytes + PCB_SOA_ALIGNMENT - 1) / PCB_SOA_ALIGNMENT * PCB_SOA_ALIGNMENT;
+    uint8_t *block = (uint8_t *)aligned_alloc(PCB_SOA_ALIGNMENT, block_bytes);
+    if (!block)
+    {
+        fprintf(stderr, "%s:%d error allocating memory\n", __FILE__, __LINE__);
+        return false;
+    }
+    memset(block, 0, block_bytes);
+
+    soa->count = count;
+    soa->burst_time = (uint32_t *)block;
+    soa->priority = (uint32_t *)(block + array_bytes);
+    soa->arrival = (uint32_t *)(block + 2 * array_bytes);
+    soa->started = (uint64_t *)(block + 3 * array_bytes);
+    soa->block = block;
     return true;
 }
 
-///*
-// preston's load_process_control_blocks
-// Reads the PCB burst time values from the binary file into ProcessControlBlock_t remaining_burst_time field
-// for N number of PCB burst time stored in the file.
-// \param input_file the file containing the PCB burst times
-// \return a populated dyn_array of ProcessControlBlocks if function ran successful else NULL for an error
-dyn_array_t *load_process_control_blocks(const char *input_file)
+void pcb_soa_destroy(PcbSoA_t *soa)
 {
-    // check invaild parametes
-    if (input_file == NULL)
+    if (soa)
     {
-        fprintf(stderr, "%s:%d invalid parameter\n", __FILE__, __LINE__);
-        return NULL;
+        free(soa->block);
+        memset(soa, 0, sizeof(PcbSoA_t));
     }
+}
 
-    FILE *ptr = fopen(input_file, "rb");
-    // make sure the file opens
-    if (ptr == NULL)
+bool load_process_control_soa(const char *input_file, PcbSoA_t *soa)
+{
+    // check invaild parametes
+    if (input_file == NULL || soa == NULL)
     {
-        fprintf(stderr, "%s:%d error opening file\n", __FILE__, __LINE__);
-        return NULL;
+        fprintf(stderr, "%s:%d invalid parameter\n", __FILE__, __LINE__);
+        return false;
     }
 
-    // Validate file size before reading pcb_count
-    fseek(ptr, 0, SEEK_END);
-    long file_size = ftell(ptr);
-    rewind(ptr);
-    // check the size of the file
-    if ((unsigned int)file_size < sizeof(uint32_t))
+    // records are read in chunks and scattered into the arrays, the chunk buffer is too big for the stack
+    PcbStream_t *stream = (PcbStream_t *)malloc(sizeof(PcbStream_t));
+    if (!stream)
     {
-        fprintf(stderr, "%s:%d file too small to contain PCB count\n", __FILE__, __LINE__);
-        fclose(ptr);
-        return NULL;
+        fprintf(stderr, "%s:%d error allocating memory\n", __FILE__, __LINE__);
+        return false;
     }
-    // read the pcb count
-    uint32_t pcb_count;
-    if (fread(&pcb_count, sizeof(uint32_t), 1, ptr) != 1)
+    if (!open_process_control_stream(input_file, stream))
     {
-        fprintf(stderr, "%s:%d error reading PCB count\n", __FILE__, __LINE__);
-        fclose(ptr);
-        return NULL;
+        free(stream);
+        return false;
     }
 
-    // Check for overflow risk and invalid values
-    const uint32_t MAX_PCB_COUNT = 4294967295; // Set to largest uint32 value
-    if (pcb_count == 0 || pcb_count > MAX_PCB_COUNT)
+    // Validate file size before allocating anything (only regular files know their size)
+    uint32_t pcb_count = stream->remaining;
+    struct stat file_stat;
+    if (fstat(stream->fd, &file_stat) != 0
+        || (S_ISREG(file_stat.st_mode)
+            && ((size_t)file_stat.st_size - sizeof(uint32_t)) / sizeof(ProcessControlRecord_t) < pcb_count))
     {
         fprintf(stderr, "%s:%d invalid PCB count: %u\n", __FILE__, __LINE__, pcb_count);
-        fclose(ptr);
-        return NULL;
+        close_process_control_stream(stream);
+        free(stream);
+        return false;
     }
 
-    // load process control block
-    ProcessControlBlock_t *pc = (ProcessControlBlock_t *)malloc(sizeof(ProcessControlBlock_t) * pcb_count);
-    // check if load fails
-    if (!pc)
+    if (!pcb_soa_create(pcb_count, soa))
     {
-        fprintf(stderr, "%s:%d error allocating memory\n", __FILE__, __LINE__);
-        fclose(ptr);
-        return NULL;
+        close_process_control_stream(stream);
+        free(stream);
+        return false;
     }
-    // iterate over the total blocks
-    for (uint32_t i = 0; i < pcb_count; ++i)
+
+    size_t loaded = 0;
+    while (read_process_control_chunk(stream))
     {
-        // check that each vlaue can be for tht block
-        if (fread(&pc[i].remaining_burst_time, sizeof(uint32_t), 1, ptr) != 1 || fread(&pc[i].priority, sizeof(uint32_t), 1, ptr) != 1 || fread(&pc[i].arrival, sizeof(uint32_t), 1, ptr) != 1)
+        for (size_t i = 0; i < stream->count; ++i, ++loaded)
         {
-            fprintf(stderr, "%s:%d error reading PCB %u\n", __FILE__, __LINE__, i);
-            free(pc);
-            fclose(ptr);
-            return NULL;
+            soa->burst_time[loaded] = stream->chunk[i].burst_time;
+            soa->priority[loaded] = stream->chunk[i].priority;
+            soa->arrival[loaded] = stream->chunk[i].arrival;
         }
-        // output the read values
-        // printf("burst = %u priority = %u arrival = %u\n", pc[i].remaining_burst_time, pc[i].priority, pc[i].arrival);
-        // initialize start
-        pc[i].started = false;
     }
-    // handle the file
-    fclose(ptr);
-    // import the read pcb's into a new dynamic array
-    dyn_array_t *dyn_array = dyn_array_import(pc, pcb_count, sizeof(ProcessControlBlock_t), NULL);
-    // check for failed dynamic array
-    if (!dyn_array)
+    bool complete = stream->remaining == 0;
+    close_process_control_stream(stream);
+    free(stream);
+    if (!complete)
     {
-        fprintf(stderr, "%s:%d error creating dynamic array\n", __FILE__, __LINE__);
-        free(pc);
-        return NULL;
+        pcb_soa_destroy(soa);
+        return false;
     }
-    // handle the allocated memory
-    free(pc);
-    // return value
-    return dyn_array;
+    return true;
 }
 
-bool shortest_remaining_time_first(dyn_array_t *ready_queue, ScheduleResult_t *result)
+bool pcb_soa_from_blocks(const dyn_array_t *pcbs, PcbSoA_t *soa)
 {
-    // Initialize statistics
-    unsigned long total_wait_time = 0;
-    unsigned long total_turnaround_time = 0;
-    unsigned long total_run_time = 0;
-    uint32_t current_time = 0;
-
-    // Validate input parameters
-    if (!ready_queue || !result) {
-        fprintf(stderr, "Error: NULL ready_queue or result\n");
+    if (!pcbs || dyn_array_data_size(pcbs) != sizeof(ProcessControlBlock_t))
+    {
+        fprintf(stderr, "%s:%d invalid parameter\n", __FILE__, __LINE__);
         return false;
     }
-
-    // Get the size of the queue
-    size_t originalArraySize = dyn_array_size(ready_queue);
-    size_t n = originalArraySize;
-
-    // Check for empty array
-    if (n == 0) {
-        // If the queue is empty, zero out the results
-        result->average_waiting_time = 0.0f;
-        result->average_turnaround_time = 0.0f;
-        result->total_run_time = 0UL;
-        return true;
+    size_t pcb_count = dyn_array_size(pcbs);
+    if (!pcb_soa_create(pcb_count, soa))
+    {
+        return false;
     }
 
-    while (n > 0) {
-
-        // Sort the ready queue based on remaining burst time
-        if (!dyn_array_sort(ready_queue, sjf_compare)) {
-            fprintf(stderr, "Failed to sort ready queue\n");
-            return false;
-        }
-        
-        // Get the process with the shortest remaining burst time
-        ProcessControlBlock_t *current_process = dyn_array_at(ready_queue, 0);
-        if (!current_process) {
-            return false; // Error: process is NULL
-        }
-
-        // If the current time is less than the process's arrival time, wait for it to arrive
-        if (current_time < current_process->arrival) {
-            current_time = current_process->arrival;
-        }
-
-        // Calculate wait time and turnaround time
-        uint32_t wait_time = current_time - current_process->arrival;
-        uint32_t turnaround_time = wait_time + current_process->remaining_burst_time;
-
-        // Update statistics
-        total_wait_time += wait_time;
-        total_turnaround_time += turnaround_time;
-        total_run_time += current_process->remaining_burst_time;
-
-        // Run the process (decrease its remaining burst time by 1)
-        virtual_cpu(current_process);
-        current_time++;
-
-        // If the process has finished, remove it from the ready queue
-        if (current_process->remaining_burst_time == 0) {
-            dyn_array_pop_front(ready_queue);
+    const ProcessControlBlock_t *pcb = (const ProcessControlBlock_t *)dyn_array_export(pcbs);
+    for (size_t i = 0; i < pcb_count; ++i, ++pcb)
+    {
+        soa->burst_time[i] = pcb->remaining_burst_time;
+        soa->priority[i] = pcb->priority;
+        soa->arrival[i] = pcb->arrival;
+        if (pcb->started)
+        {
+            soa->started[i / 64] |= 1ULL << (i % 64);
         }
-
-        // Update the current time
-        //current_time += current_process->remaining_burst_time;
-
-
-        // Update the size of the ready queue
-        n = dyn_array_size(ready_queue);
     }
-
-    // Calculate averages
-    result->average_waiting_time = (float)total_wait_time / originalArraySize;
-    result->average_turnaround_time = (float)total_turnaround_time / originalArraySize;
-    result->total_run_time = total_run_time;
-
     return true;
 }
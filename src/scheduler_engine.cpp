@@ -0,0 +1,222 @@
+#include <cstdio>
+#include <new>
+
+#include "scheduler_engine.hpp"
+
+// The C entry points, each one validates its arguments and runs one instantiation of the engine
+
+namespace
+{
+
+void zero_result(ScheduleResult_t *result)
+{
+    result->average_waiting_time = 0.0f;
+    result->average_turnaround_time = 0.0f;
+    result->total_run_time = 0UL;
+}
+
+size_t queue_size(const dyn_array_t *ready_queue)
+{
+    return dyn_array_size(ready_queue);
+}
+
+size_t queue_size(const PcbSoA_t *ready_queue)
+{
+    return ready_queue->count;
+}
+
+// Validates the arguments shared by every policy and runs Policy, an empty queue gives zeroed results
+template <class Policy, class Queue, class Parameter = size_t>
+bool schedule_queue(Queue *ready_queue, ScheduleResult_t *result, Parameter parameter = Parameter())
+{
+    // Validate inputs
+    if (!ready_queue || !result)
+    {
+        fprintf(stderr, "%s:%d invalid parameter\n", __FILE__, __LINE__);
+        return false;
+    }
+
+    // check if the queue is empty and handle case
+    if (queue_size(ready_queue) == 0)
+    {
+        zero_result(result);
+        return true;
+    }
+
+    try
+    {
+        if (!scheduler_engine::schedule<Policy>(ready_queue, result, parameter))
+        {
+            fprintf(stderr, "%s:%d failed to schedule ready queue\n", __FILE__, __LINE__);
+            return false;
+        }
+    }
+    catch (const std::bad_alloc &)
+    {
+        fprintf(stderr, "%s:%d error allocating memory\n", __FILE__, __LINE__);
+        return false;
+    }
+    return true;
+}
+
+}  // namespace
+
+extern "C" void set_scheduler_threads(size_t threads)
+{
+    scheduler_engine::set_pass_threads(threads);
+}
+
+extern "C" void set_scheduler_parallel_sort_threshold(size_t pcbs)
+{
+    scheduler_engine::set_parallel_sort_threshold(pcbs);
+}
+
+extern "C" bool first_come_first_serve(dyn_array_t *ready_queue, ScheduleResult_t *result)
+{
+    return schedule_queue<scheduler_engine::FirstComeFirstServe>(ready_queue, result);
+}
+
+extern "C" bool first_come_first_serve_stream(PcbStream_t *stream, ScheduleResult_t *result)
+{
+    // Validate inputs
+    if (!stream || !result)
+    {
+        fprintf(stderr, "%s:%d invalid parameter\n", __FILE__, __LINE__);
+        return false;
+    }
+
+    scheduler_engine::NonPreemptivePass<scheduler_engine::FirstComeFirstServe> pass;
+    uint32_t last_arrival = 0;
+
+    // only one chunk is ever held, no matter how long the trace is
+    while (read_process_control_chunk(stream))
+    {
+        for (size_t i = 0; i < stream->count; ++i)
+        {
+            const ProcessControlRecord_t *record = &stream->chunk[i];
+            if (record->arrival < last_arrival)
+            {
+                fprintf(stderr, "%s:%d stream is not in arrival order at PCB %zu\n", __FILE__, __LINE__, pass.count() + i);
+                return false;
+            }
+            last_arrival = record->arrival;
+        }
+        pass.account(&stream->chunk[0].burst_time, &stream->chunk[0].arrival, stream->count,
+                     sizeof(ProcessControlRecord_t) / sizeof(uint32_t));
+    }
+    if (stream->remaining)
+    {
+        fprintf(stderr, "%s:%d stream ended early\n", __FILE__, __LINE__);
+        return false;
+    }
+
+    pass.report(result);
+    return true;
+}
+
+extern "C" bool shortest_job_first(dyn_array_t *ready_queue, ScheduleResult_t *result)
+{
+    return schedule_queue<scheduler_engine::ShortestJobFirst>(ready_queue, result);
+}
+
+extern "C" bool priority(dyn_array_t *ready_queue, ScheduleResult_t *result)
+{
+    return schedule_queue<scheduler_engine::Priority>(ready_queue, result);
+}
+
+extern "C" bool shortest_job_first_arrival_aware(dyn_array_t *ready_queue, ScheduleResult_t *result)
+{
+    return schedule_queue<scheduler_engine::ShortestJobFirstArrivalAware>(ready_queue, result);
+}
+
+extern "C" bool priority_arrival_aware(dyn_array_t *ready_queue, ScheduleResult_t *result)
+{
+    return schedule_queue<scheduler_engine::PriorityArrivalAware>(ready_queue, result);
+}
+
+extern "C" bool first_come_first_serve_soa(PcbSoA_t *soa, ScheduleResult_t *result)
+{
+    return schedule_queue<scheduler_engine::FirstComeFirstServe>(soa, result);
+}
+
+extern "C" bool shortest_job_first_soa(PcbSoA_t *soa, ScheduleResult_t *result)
+{
+    return schedule_queue<scheduler_engine::ShortestJobFirst>(soa, result);
+}
+
+extern "C" bool priority_soa(PcbSoA_t *soa, ScheduleResult_t *result)
+{
+    return schedule_queue<scheduler_engine::Priority>(soa, result);
+}
+
+extern "C" bool shortest_remaining_time_first(dyn_array_t *ready_queue, ScheduleResult_t *result)
+{
+    return schedule_queue<scheduler_engine::ShortestRemainingTimeFirst>(ready_queue, result);
+}
+
+extern "C" bool preemptive_priority(dyn_array_t *ready_queue, ScheduleResult_t *result, size_t aging_interval)
+{
+    // keeps priority * interval from overflowing
+    if (aging_interval > UINT32_MAX)
+    {
+        fprintf(stderr, "%s:%d invalid aging interval\n", __FILE__, __LINE__);
+        return false;
+    }
+    return schedule_queue<scheduler_engine::PreemptivePriority>(ready_queue, result, aging_interval);
+}
+
+extern "C" bool multi_level_feedback_queue(dyn_array_t *ready_queue, ScheduleResult_t *result,
+                                           const MlfqConfig_t *config)
+{
+    if (!config || config->levels == 0 || config->levels > MLFQ_MAX_LEVELS || !config->quanta)
+    {
+        fprintf(stderr, "%s:%d invalid feedback queue configuration\n", __FILE__, __LINE__);
+        return false;
+    }
+    for (size_t level = 0; level < config->levels; ++level)
+    {
+        if (config->quanta[level] == 0)
+        {
+            fprintf(stderr, "%s:%d level %zu has a zero quantum\n", __FILE__, __LINE__, level);
+            return false;
+        }
+    }
+    return schedule_queue<scheduler_engine::MultiLevelFeedbackQueue>(ready_queue, result, config);
+}
+
+extern "C" bool multi_core_first_come_first_serve(dyn_array_t *ready_queue, ScheduleResult_t *result,
+                                                  const MultiCoreConfig_t *config, float *core_utilization)
+{
+    if (!config || config->cores == 0 || (config->steal != STEAL_RANDOM_VICTIM && config->steal != STEAL_MOST_LOADED))
+    {
+        fprintf(stderr, "%s:%d invalid multi-core configuration\n", __FILE__, __LINE__);
+        return false;
+    }
+    // an empty queue leaves every core idle
+    for (size_t core = 0; core_utilization && core < config->cores; ++core)
+    {
+        core_utilization[core] = 0.0f;
+    }
+    scheduler_engine::MultiCoreRun parameter = {config, core_utilization};
+    return schedule_queue<scheduler_engine::MultiCoreFirstComeFirstServe>(ready_queue, result, parameter);
+}
+
+extern "C" bool completely_fair(dyn_array_t *ready_queue, ScheduleResult_t *result, const CfsConfig_t *config)
+{
+    if (!config || config->target_latency == 0 || config->min_granularity == 0)
+    {
+        fprintf(stderr, "%s:%d invalid fair scheduling configuration\n", __FILE__, __LINE__);
+        return false;
+    }
+    return schedule_queue<scheduler_engine::CompletelyFair>(ready_queue, result, config);
+}
+
+extern "C" bool round_robin(dyn_array_t *ready_queue, ScheduleResult_t *result, size_t quantum)
+{
+    // round robin has always refused an empty queue and a zero quantum
+    if (!ready_queue || !result || quantum == 0 || dyn_array_size(ready_queue) == 0)
+    {
+        return false;
+    }
+    return schedule_queue<scheduler_engine::RoundRobin>(ready_queue, result, quantum);
+}
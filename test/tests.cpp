@@ -1,8 +1,12 @@
 #include <fcntl.h>
 #include <stdio.h>
 #include <pthread.h>
+#include <algorithm>
+#include <climits>
+#include <vector>
 #include "gtest/gtest.h"
 #include "processing_scheduling.h"
+#include "scheduler_engine.hpp"
 
 // Using a C library requires extern "C" to prevent function mangling
 extern "C"
@@ -15,6 +19,31 @@ extern "C"
 unsigned int score;
 unsigned int total;
 
+// count pcbs from an LCG seeded with seed: burst burst_min + r % burst_span,
+// priority priority_min + r % priority_span and arrival r % arrival_span
+static std::vector<ProcessControlBlock_t> random_pcbs(uint32_t seed, size_t count, uint32_t burst_min, uint32_t burst_span,
+                                                      uint32_t priority_min, uint32_t priority_span, uint32_t arrival_span)
+{
+    std::vector<ProcessControlBlock_t> pcbs;
+    uint32_t state = seed;
+    for (size_t i = 0; i < count; ++i)
+    {
+        state = state * 1103515245u + 12345u;
+        ProcessControlBlock_t pcb = {burst_min + (state >> 8) % burst_span, priority_min + (state >> 4) % priority_span,
+                                     (state >> 12) % arrival_span, false};
+        pcbs.push_back(pcb);
+    }
+    return pcbs;
+}
+
+// pcbs stably sorted by arrival, the order the event driven engines run them in
+static std::vector<ProcessControlBlock_t> sorted_by_arrival(std::vector<ProcessControlBlock_t> pcbs)
+{
+    std::stable_sort(pcbs.begin(), pcbs.end(),
+                     [](const ProcessControlBlock_t &a, const ProcessControlBlock_t &b) { return a.arrival < b.arrival; });
+    return pcbs;
+}
+
 // check if load process doesn't have existing file
 TEST(LoadProcessControlBlocks, FileDoesNotExist)
 {
@@ -139,6 +168,667 @@ TEST(LoadProcessControlBlocksTest, ValidFile_ReadActual)
     dyn_array_destroy(pcb_array);
 }
 
+TEST(DynArrayAdopt, TakesOwnershipWithoutCopy)
+{
+    int *data = (int *)malloc(sizeof(int) * 3);
+    ASSERT_NE(data, nullptr);
+    data[0] = 1;
+    data[1] = 2;
+    data[2] = 3;
+    dyn_array_t *array = dyn_array_adopt(data, 3, sizeof(int), nullptr);
+    ASSERT_NE(array, nullptr);
+    EXPECT_EQ(dyn_array_export(array), (const void *)data);
+    // growing reallocates the adopted buffer
+    int four = 4;
+    ASSERT_TRUE(dyn_array_push_back(array, &four));
+    EXPECT_EQ(dyn_array_size(array), (size_t)4);
+    EXPECT_EQ(*(int *)dyn_array_at(array, 2), 3);
+    EXPECT_EQ(*(int *)dyn_array_back(array), 4);
+    dyn_array_destroy(array);
+}
+
+TEST(DynArraySortByKey, StableWithTiebreakMatchesComparator)
+{
+    dyn_array_t *keyed = dyn_array_create(0, sizeof(ProcessControlBlock_t), nullptr);
+    dyn_array_t *compared = dyn_array_create(0, sizeof(ProcessControlBlock_t), nullptr);
+    ASSERT_NE(keyed, nullptr);
+    ASSERT_NE(compared, nullptr);
+    // wide keys so every byte of the radix passes matters, few distinct arrivals so the tiebreak decides equal bursts
+    uint32_t state = 12345;
+    for (int i = 0; i < 2000; ++i)
+    {
+        state = state * 1103515245u + 12345u;
+        ProcessControlBlock_t pcb = {(state >> 8) % 7 * 0x01010101u, 0, (state >> 4) % 5 * 0x00ff00ffu, false};
+        dyn_array_push_back(keyed, &pcb);
+        dyn_array_push_back(compared, &pcb);
+    }
+    ASSERT_TRUE(dyn_array_sort_by_u32_key(keyed, offsetof(ProcessControlBlock_t, remaining_burst_time),
+                                          offsetof(ProcessControlBlock_t, arrival)));
+    ASSERT_TRUE(dyn_array_sort(compared, sjf_compare));
+    for (size_t i = 0; i < 2000; ++i)
+    {
+        ProcessControlBlock_t *a = (ProcessControlBlock_t *)dyn_array_at(keyed, i);
+        ProcessControlBlock_t *b = (ProcessControlBlock_t *)dyn_array_at(compared, i);
+        EXPECT_EQ(a->remaining_burst_time, b->remaining_burst_time);
+        EXPECT_EQ(a->arrival, b->arrival);
+    }
+    dyn_array_destroy(keyed);
+    dyn_array_destroy(compared);
+}
+
+TEST(DynArraySortByKey, KeepsInputOrderOfEqualKeys)
+{
+    dyn_array_t *ring = dyn_array_create_ring(4, sizeof(ProcessControlBlock_t), nullptr);
+    ASSERT_NE(ring, nullptr);
+    // pushed to the front so the ring is wrapped, priority records the logical position
+    for (uint32_t i = 0; i < 10; ++i)
+    {
+        ProcessControlBlock_t pcb = {1, 9 - i, (9 - i) % 3, false};
+        dyn_array_push_front(ring, &pcb);
+    }
+    ASSERT_TRUE(dyn_array_sort_by_u32_key(ring, offsetof(ProcessControlBlock_t, arrival), DYN_NO_TIEBREAK));
+    uint32_t expected[] = {0, 3, 6, 9, 1, 4, 7, 2, 5, 8};
+    for (size_t i = 0; i < 10; ++i)
+    {
+        EXPECT_EQ(((ProcessControlBlock_t *)dyn_array_at(ring, i))->priority, expected[i]);
+    }
+    EXPECT_FALSE(dyn_array_sort_by_u32_key(ring, sizeof(ProcessControlBlock_t), DYN_NO_TIEBREAK));
+    dyn_array_destroy(ring);
+}
+
+TEST(DynArraySortParallel, StableAcrossThreadsMatchesRadix)
+{
+    dyn_array_t *parallel = dyn_array_create(0, sizeof(ProcessControlBlock_t), nullptr);
+    dyn_array_t *radix = dyn_array_create(0, sizeof(ProcessControlBlock_t), nullptr);
+    ASSERT_NE(parallel, nullptr);
+    ASSERT_NE(radix, nullptr);
+    // few distinct bursts so there are long runs of ties, priority records the input order
+    uint32_t state = 520;
+    for (uint32_t i = 0; i < 50000; ++i)
+    {
+        state = state * 1103515245u + 12345u;
+        ProcessControlBlock_t pcb = {(state >> 8) % 13, i, 0, false};
+        dyn_array_push_back(parallel, &pcb);
+        dyn_array_push_back(radix, &pcb);
+    }
+    ASSERT_TRUE(dyn_array_sort_parallel(parallel, sjf_compare, 5, true));
+    ASSERT_TRUE(dyn_array_sort_by_u32_key(radix, offsetof(ProcessControlBlock_t, remaining_burst_time), DYN_NO_TIEBREAK));
+    for (size_t i = 0; i < 50000; ++i)
+    {
+        ProcessControlBlock_t *a = (ProcessControlBlock_t *)dyn_array_at(parallel, i);
+        ProcessControlBlock_t *b = (ProcessControlBlock_t *)dyn_array_at(radix, i);
+        ASSERT_EQ(a->remaining_burst_time, b->remaining_burst_time);
+        ASSERT_EQ(a->priority, b->priority);
+    }
+
+    // unstable only promises the order of the keys
+    ASSERT_TRUE(dyn_array_sort_parallel(radix, arrival_time_compare, 3, false));
+    ASSERT_TRUE(dyn_array_sort_parallel(radix, priority_compare, 0, false));
+    for (size_t i = 1; i < 50000; ++i)
+    {
+        EXPECT_LE(((ProcessControlBlock_t *)dyn_array_at(radix, i - 1))->priority,
+                  ((ProcessControlBlock_t *)dyn_array_at(radix, i))->priority);
+    }
+    EXPECT_FALSE(dyn_array_sort_parallel(radix, nullptr, 2, true));
+    dyn_array_destroy(parallel);
+    dyn_array_destroy(radix);
+}
+
+TEST(DynArraySortParallel, SchedulersGiveTheSameResults)
+{
+    uint32_t state = 520;
+    dyn_array_t *workload = dyn_array_create(0, sizeof(ProcessControlBlock_t), nullptr);
+    ASSERT_NE(workload, nullptr);
+    for (uint32_t i = 0; i < 40000; ++i)
+    {
+        state = state * 1103515245u + 12345u;
+        ProcessControlBlock_t pcb = {1 + (state >> 8) % 100, (state >> 4) % 16, (state >> 12) % 100000, false};
+        dyn_array_push_back(workload, &pcb);
+    }
+    bool (*schedulers[])(dyn_array_t *, ScheduleResult_t *) = {first_come_first_serve, shortest_job_first, priority};
+    for (size_t s = 0; s < 3; ++s)
+    {
+        ScheduleResult_t results[2];
+        for (int parallel = 0; parallel < 2; ++parallel)
+        {
+            // enough threads that the schedulers pick the parallel sort
+            set_scheduler_threads(parallel ? 8 : 1);
+            set_scheduler_parallel_sort_threshold(parallel ? 1 : SCHEDULER_PARALLEL_SORT_THRESHOLD);
+            dyn_array_t *queue = dyn_array_import(dyn_array_export(workload), 40000, sizeof(ProcessControlBlock_t), nullptr);
+            ASSERT_NE(queue, nullptr);
+            ASSERT_TRUE(schedulers[s](queue, &results[parallel]));
+            dyn_array_destroy(queue);
+        }
+        EXPECT_FLOAT_EQ(results[1].average_waiting_time, results[0].average_waiting_time);
+        EXPECT_FLOAT_EQ(results[1].average_turnaround_time, results[0].average_turnaround_time);
+        EXPECT_EQ(results[1].total_run_time, results[0].total_run_time);
+    }
+    set_scheduler_threads(0);
+    set_scheduler_parallel_sort_threshold(SCHEDULER_PARALLEL_SORT_THRESHOLD);
+    dyn_array_destroy(workload);
+}
+
+TEST(DynArrayCapacity, ReserveShrinkAndRegrow)
+{
+    dyn_array_t *array = dyn_array_create(0, sizeof(int), nullptr);
+    ASSERT_NE(array, nullptr);
+    ASSERT_TRUE(dyn_array_reserve(array, 1000));
+    EXPECT_EQ(dyn_array_capacity(array), (size_t)1000);
+    for (int i = 0; i < 1000; ++i)
+    {
+        ASSERT_TRUE(dyn_array_push_back(array, &i));
+    }
+    // everything fit in the reservation
+    EXPECT_EQ(dyn_array_capacity(array), (size_t)1000);
+    EXPECT_TRUE(dyn_array_reserve(array, 10));
+
+    for (int i = 0; i < 997; ++i)
+    {
+        ASSERT_TRUE(dyn_array_pop_back(array));
+    }
+    dyn_array_shrink_to_fit(array);
+    EXPECT_EQ(dyn_array_capacity(array), (size_t)3);
+    int value = 3;
+    ASSERT_TRUE(dyn_array_push_back(array, &value));
+    EXPECT_EQ(dyn_array_capacity(array), (size_t)16);
+    for (int i = 0; i < 4; ++i)
+    {
+        EXPECT_EQ(*(int *)dyn_array_at(array, i), i);
+    }
+    dyn_array_destroy(array);
+}
+
+TEST(DynArrayCapacity, SlowGrowthKeepsWrappedRingInOrder)
+{
+    dyn_array_t *ring = dyn_array_create_ring(16, sizeof(int), nullptr);
+    ASSERT_NE(ring, nullptr);
+    ASSERT_TRUE(dyn_array_set_growth(ring, 125, false));
+    EXPECT_FALSE(dyn_array_set_growth(ring, 100, false));
+    // the front pushes wrap the ring around, then the back pushes grow it by a quarter at a time
+    for (int i = 0; i < 12; ++i)
+    {
+        int value = 11 - i;
+        ASSERT_TRUE(dyn_array_push_front(ring, &value));
+    }
+    for (int i = 12; i < 100; ++i)
+    {
+        ASSERT_TRUE(dyn_array_push_back(ring, &i));
+    }
+    EXPECT_LT(dyn_array_capacity(ring), (size_t)128);
+    for (int i = 0; i < 100; ++i)
+    {
+        EXPECT_EQ(*(int *)dyn_array_at(ring, i), i);
+    }
+    dyn_array_destroy(ring);
+}
+
+TEST(DynArrayCapacity, ShrinksOnDrain)
+{
+    dyn_array_t *queue = dyn_array_create_ring(0, sizeof(int), nullptr);
+    ASSERT_NE(queue, nullptr);
+    ASSERT_TRUE(dyn_array_set_growth(queue, DYN_DEFAULT_GROWTH_PERCENT, true));
+    for (int i = 0; i < 4096; ++i)
+    {
+        ASSERT_TRUE(dyn_array_push_back(queue, &i));
+    }
+    EXPECT_EQ(dyn_array_capacity(queue), (size_t)4096);
+    int value;
+    for (int i = 0; i < 4090; ++i)
+    {
+        ASSERT_TRUE(dyn_array_extract_front(queue, &value));
+        ASSERT_EQ(value, i);
+    }
+    EXPECT_EQ(dyn_array_capacity(queue), (size_t)16);
+    for (int i = 4090; i < 4096; ++i)
+    {
+        ASSERT_TRUE(dyn_array_extract_front(queue, &value));
+        EXPECT_EQ(value, i);
+    }
+    dyn_array_destroy(queue);
+}
+
+static size_t destructed_count = 0;
+static void count_destruct(void *) { ++destructed_count; }
+
+TEST(DynArrayBulk, PushExtractInsertErase)
+{
+    int values[100];
+    for (int i = 0; i < 100; ++i)
+    {
+        values[i] = i;
+    }
+    for (int ring = 0; ring < 2; ++ring)
+    {
+        destructed_count = 0;
+        dyn_array_t *array = ring ? dyn_array_create_ring(0, sizeof(int), count_destruct)
+                                  : dyn_array_create(0, sizeof(int), count_destruct);
+        ASSERT_NE(array, nullptr);
+        ASSERT_TRUE(dyn_array_push_back_n(array, values, 60));
+        int out[100];
+        ASSERT_TRUE(dyn_array_extract_front_n(array, out, 20));
+        for (int i = 0; i < 20; ++i)
+        {
+            EXPECT_EQ(out[i], i);
+        }
+        // rings wrap here, the front moved up and the back runs past the end
+        ASSERT_TRUE(dyn_array_push_back_n(array, values + 60, 40));
+        EXPECT_FALSE(dyn_array_extract_front_n(array, out, 81));
+        EXPECT_EQ(dyn_array_size(array), (size_t)80);
+
+        // 20..99 -> 20..29, 0..4, 30..99
+        ASSERT_TRUE(dyn_array_insert_n(array, 10, values, 5));
+        EXPECT_FALSE(dyn_array_insert_n(array, 86, values, 5));
+        EXPECT_EQ(*(int *)dyn_array_at(array, 9), 29);
+        EXPECT_EQ(*(int *)dyn_array_at(array, 10), 0);
+        EXPECT_EQ(*(int *)dyn_array_at(array, 15), 30);
+
+        // 20..29, 0..4, 30..39, 90..99
+        ASSERT_TRUE(dyn_array_erase_range(array, 25, 50));
+        EXPECT_EQ(destructed_count, (size_t)50);
+        EXPECT_FALSE(dyn_array_erase_range(array, 25, 11));
+        EXPECT_FALSE(dyn_array_erase_range(array, 1, SIZE_MAX));
+        ASSERT_EQ(dyn_array_size(array), (size_t)35);
+        EXPECT_EQ(*(int *)dyn_array_at(array, 24), 39);
+        EXPECT_EQ(*(int *)dyn_array_at(array, 25), 90);
+
+        ASSERT_TRUE(dyn_array_extract_front_n(array, out, 35));
+        EXPECT_EQ(out[14], 4);
+        EXPECT_EQ(out[34], 99);
+        EXPECT_TRUE(dyn_array_empty(array));
+        EXPECT_FALSE(dyn_array_push_back_n(array, nullptr, 3));
+        dyn_array_destroy(array);
+    }
+}
+
+TEST(DynArrayInsertSorted, EqualsGoAfterAndBatchesMatch)
+{
+    dyn_array_t *single = dyn_array_create_ring(0, sizeof(ProcessControlBlock_t), nullptr);
+    dyn_array_t *batched = dyn_array_create(0, sizeof(ProcessControlBlock_t), nullptr);
+    ASSERT_NE(single, nullptr);
+    ASSERT_NE(batched, nullptr);
+    // few distinct arrivals so there are lots of ties, priority records the insertion order
+    uint32_t state = 520;
+    ProcessControlBlock_t batch[37];
+    for (uint32_t i = 0; i < 37 * 40; ++i)
+    {
+        state = state * 1103515245u + 12345u;
+        ProcessControlBlock_t pcb = {1, i, (state >> 8) % 50, false};
+        ASSERT_TRUE(dyn_array_insert_sorted(single, &pcb, arrival_time_compare));
+        batch[i % 37] = pcb;
+        if (i % 37 == 36)
+        {
+            ASSERT_TRUE(dyn_array_insert_sorted_many(batched, batch, 37, arrival_time_compare));
+        }
+    }
+    ASSERT_EQ(dyn_array_size(batched), dyn_array_size(single));
+    for (size_t i = 0; i < dyn_array_size(single); ++i)
+    {
+        ProcessControlBlock_t *a = (ProcessControlBlock_t *)dyn_array_at(single, i);
+        ProcessControlBlock_t *b = (ProcessControlBlock_t *)dyn_array_at(batched, i);
+        ASSERT_EQ(a->arrival, b->arrival);
+        ASSERT_EQ(a->priority, b->priority);
+        if (i)
+        {
+            ProcessControlBlock_t *previous = (ProcessControlBlock_t *)dyn_array_at(single, i - 1);
+            ASSERT_TRUE(previous->arrival < a->arrival || previous->priority < a->priority);
+        }
+    }
+    EXPECT_FALSE(dyn_array_insert_sorted_many(batched, batch, 0, arrival_time_compare));
+    EXPECT_FALSE(dyn_array_insert_sorted_many(batched, nullptr, 37, arrival_time_compare));
+    dyn_array_destroy(single);
+    dyn_array_destroy(batched);
+}
+
+// counts live bytes so the tests can tell nothing went around the allocator
+struct CountingContext
+{
+    size_t live_bytes;
+    size_t calls;
+};
+
+static void *counting_alloc(void *context, const size_t size)
+{
+    CountingContext *counts = (CountingContext *)context;
+    counts->live_bytes += size;
+    ++counts->calls;
+    return malloc(size);
+}
+
+static void *counting_realloc(void *context, void *ptr, const size_t old_size, const size_t new_size)
+{
+    CountingContext *counts = (CountingContext *)context;
+    counts->live_bytes += new_size - old_size;
+    ++counts->calls;
+    return realloc(ptr, new_size);
+}
+
+static void counting_free(void *context, void *ptr, const size_t size)
+{
+    CountingContext *counts = (CountingContext *)context;
+    counts->live_bytes -= size;
+    ++counts->calls;
+    free(ptr);
+}
+
+TEST(DynArrayAllocator, EverythingGoesThroughTheAllocator)
+{
+    CountingContext counts = {0, 0};
+    dyn_allocator_t allocator = {counting_alloc, counting_realloc, counting_free, &counts};
+    dyn_array_t *array = dyn_array_create_with_allocator(0, sizeof(ProcessControlBlock_t), nullptr, &allocator);
+    ASSERT_NE(array, nullptr);
+    uint32_t state = 520;
+    for (uint32_t i = 0; i < 20000; ++i)
+    {
+        state = state * 1103515245u + 12345u;
+        ProcessControlBlock_t pcb = {(state >> 8) % 100, i, 0, false};
+        ASSERT_TRUE(dyn_array_push_back(array, &pcb));
+    }
+    // growth, both sorts' scratch buffers and a shrink
+    ASSERT_TRUE(dyn_array_sort_by_u32_key(array, offsetof(ProcessControlBlock_t, remaining_burst_time), DYN_NO_TIEBREAK));
+    ASSERT_TRUE(dyn_array_sort_parallel(array, priority_compare, 2, true));
+    for (int i = 0; i < 15000; ++i)
+    {
+        ASSERT_TRUE(dyn_array_pop_back(array));
+    }
+    dyn_array_shrink_to_fit(array);
+    EXPECT_EQ(((ProcessControlBlock_t *)dyn_array_at(array, 4999))->priority, (uint32_t)4999);
+    EXPECT_GT(counts.calls, (size_t)4);
+    dyn_array_destroy(array);
+    EXPECT_EQ(counts.live_bytes, (size_t)0);
+
+    // a table without all three functions is refused
+    allocator.realloc = nullptr;
+    EXPECT_EQ(dyn_array_create_with_allocator(0, sizeof(int), nullptr, &allocator), nullptr);
+}
+
+// counting_realloc that refuses to grow while fail_grow is set
+static bool fail_grow = false;
+
+static void *failing_realloc(void *context, void *ptr, const size_t old_size, const size_t new_size)
+{
+    return fail_grow && new_size > old_size ? nullptr : counting_realloc(context, ptr, old_size, new_size);
+}
+
+TEST(DynArrayAllocator, FailedGrowAfterShrinkKeepsTheMinimum)
+{
+    CountingContext counts = {0, 0};
+    dyn_allocator_t allocator = {counting_alloc, failing_realloc, counting_free, &counts};
+    dyn_array_t *array = dyn_array_create_with_allocator(0, sizeof(int), nullptr, &allocator);
+    ASSERT_NE(array, nullptr);
+    int value = 1;
+    ASSERT_TRUE(dyn_array_push_back(array, &value));
+    dyn_array_shrink_to_fit(array);
+    ASSERT_EQ(dyn_array_capacity(array), (size_t)1);
+    fail_grow = true;
+    EXPECT_FALSE(dyn_array_push_back(array, &value));
+    fail_grow = false;
+    // the retry still jumps straight back to the create minimum
+    ASSERT_TRUE(dyn_array_push_back(array, &value));
+    EXPECT_EQ(dyn_array_capacity(array), (size_t)16);
+    dyn_array_destroy(array);
+    EXPECT_EQ(counts.live_bytes, (size_t)0);
+}
+
+TEST(DynArrayAllocator, ArenaBatch)
+{
+    dyn_arena_t *arena = dyn_arena_create(4096);
+    ASSERT_NE(arena, nullptr);
+    const dyn_allocator_t allocator = dyn_arena_allocator(arena);
+    for (int batch = 0; batch < 3; ++batch)
+    {
+        dyn_array_t *arrays[100];
+        for (int a = 0; a < 100; ++a)
+        {
+            // a few are bigger than the blocks so they get their own
+            arrays[a] = dyn_array_create_with_allocator(a % 10 ? 8 : 2000, sizeof(int), nullptr, &allocator);
+            ASSERT_NE(arrays[a], nullptr);
+        }
+        for (int a = 0; a < 100; ++a)
+        {
+            for (int i = 0; i < a * 10; ++i)
+            {
+                ASSERT_TRUE(dyn_array_push_back(arrays[a], &i));
+            }
+        }
+        for (int a = 0; a < 100; ++a)
+        {
+            ASSERT_EQ(dyn_array_size(arrays[a]), (size_t)(a * 10));
+            for (int i = 0; i < a * 10; ++i)
+            {
+                ASSERT_EQ(*(int *)dyn_array_at(arrays[a], i), i);
+            }
+        }
+        // destroying is optional, the reset takes everything
+        dyn_array_destroy(arrays[99]);
+        dyn_arena_reset(arena);
+    }
+    dyn_arena_destroy(arena);
+}
+
+TEST(DynArrayAllocator, HugePagesAreAligned)
+{
+    dyn_array_t *array = dyn_array_create_with_allocator(0, sizeof(uint32_t), nullptr, &dyn_hugepage_allocator);
+    ASSERT_NE(array, nullptr);
+    // 12MB by the end, crossing from malloc into mappings on the way
+    for (uint32_t i = 0; i < 3000000; ++i)
+    {
+        uint32_t value = 3000000 - i;
+        ASSERT_TRUE(dyn_array_push_back(array, &value));
+    }
+    EXPECT_EQ((uintptr_t)dyn_array_export(array) % (2 << 20), (uintptr_t)0);
+    ASSERT_TRUE(dyn_array_sort_by_u32_key(array, 0, DYN_NO_TIEBREAK));
+    EXPECT_EQ((uintptr_t)dyn_array_export(array) % (2 << 20), (uintptr_t)0);
+    for (uint32_t i = 0; i < 3000000; i += 1000)
+    {
+        ASSERT_EQ(*(uint32_t *)dyn_array_at(array, i), i + 1);
+    }
+    // and back under the line
+    for (uint32_t i = 0; i < 2999990; ++i)
+    {
+        ASSERT_TRUE(dyn_array_pop_back(array));
+    }
+    dyn_array_shrink_to_fit(array);
+    EXPECT_EQ(*(uint32_t *)dyn_array_at(array, 9), (uint32_t)10);
+    dyn_array_destroy(array);
+}
+
+TEST(DynArrayRing, FrontAndBackAcrossWrap)
+{
+    dyn_array_t *ring = dyn_array_create_ring(4, sizeof(int), nullptr);
+    ASSERT_NE(ring, nullptr);
+    // fill, drain from the front and refill so the contents wrap past the end
+    for (int i = 0; i < 16; ++i)
+    {
+        ASSERT_TRUE(dyn_array_push_back(ring, &i));
+    }
+    for (int i = 0; i < 12; ++i)
+    {
+        int value = -1;
+        ASSERT_TRUE(dyn_array_extract_front(ring, &value));
+        EXPECT_EQ(value, i);
+    }
+    for (int i = 16; i < 24; ++i)
+    {
+        ASSERT_TRUE(dyn_array_push_back(ring, &i));
+    }
+    int first = 11;
+    ASSERT_TRUE(dyn_array_push_front(ring, &first));
+    ASSERT_EQ(dyn_array_size(ring), (size_t)13);
+    EXPECT_EQ(*(int *)dyn_array_back(ring), 23);
+    for (size_t i = 0; i < dyn_array_size(ring); ++i)
+    {
+        EXPECT_EQ(*(int *)dyn_array_at(ring, i), (int)i + 11);
+    }
+    dyn_array_destroy(ring);
+}
+
+TEST(DynArrayRing, GrowsAndLinearizesWhileWrapped)
+{
+    dyn_array_t *ring = dyn_array_create_ring(16, sizeof(int), nullptr);
+    ASSERT_NE(ring, nullptr);
+    // push_front puts the head at the end of the buffer so the next pushes wrap
+    for (int i = 0; i < 40; ++i)
+    {
+        int value = 39 - i;
+        ASSERT_TRUE(dyn_array_push_front(ring, &value));
+    }
+    int middle = 100;
+    ASSERT_TRUE(dyn_array_insert(ring, 20, &middle));
+    ASSERT_TRUE(dyn_array_erase(ring, 20));
+    const int *data = (const int *)dyn_array_export(ring);
+    ASSERT_NE(data, nullptr);
+    for (int i = 0; i < 40; ++i)
+    {
+        EXPECT_EQ(data[i], i);
+    }
+    dyn_array_destroy(ring);
+}
+
+TEST(PcbSoA, MatchesBlockSchedulers)
+{
+    PcbSoA_t soa;
+    ASSERT_TRUE(load_process_control_soa("../pcb.bin", &soa));
+    ASSERT_EQ(soa.count, (size_t)4);
+    EXPECT_EQ((uintptr_t)soa.burst_time % PCB_SOA_ALIGNMENT, (uintptr_t)0);
+    EXPECT_EQ((uintptr_t)soa.arrival % PCB_SOA_ALIGNMENT, (uintptr_t)0);
+    EXPECT_EQ((int)soa.burst_time[0], 15);
+    EXPECT_EQ((int)soa.burst_time[3], 20);
+
+    bool (*block_schedulers[])(dyn_array_t *, ScheduleResult_t *) = {first_come_first_serve, shortest_job_first, priority};
+    bool (*soa_schedulers[])(PcbSoA_t *, ScheduleResult_t *) = {first_come_first_serve_soa, shortest_job_first_soa, priority_soa};
+    for (size_t s = 0; s < 3; ++s)
+    {
+        dyn_array_t *queue = load_process_control_blocks("../pcb.bin");
+        ASSERT_NE(queue, nullptr);
+        ScheduleResult_t expected = {0.0f, 0.0f, 0UL};
+        ASSERT_TRUE(block_schedulers[s](queue, &expected));
+
+        PcbSoA_t copy;
+        ASSERT_TRUE(pcb_soa_from_blocks(queue, &copy));
+        ScheduleResult_t actual = {0.0f, 0.0f, 0UL};
+        ASSERT_TRUE(soa_schedulers[s](&copy, &actual));
+        EXPECT_FLOAT_EQ(actual.average_waiting_time, expected.average_waiting_time);
+        EXPECT_FLOAT_EQ(actual.average_turnaround_time, expected.average_turnaround_time);
+        EXPECT_EQ(actual.total_run_time, expected.total_run_time);
+
+        // the store was reordered into the same run order as the blocks
+        for (size_t i = 0; i < copy.count; ++i)
+        {
+            ProcessControlBlock_t *pcb = (ProcessControlBlock_t *)dyn_array_at(queue, i);
+            EXPECT_EQ(copy.burst_time[i], pcb->remaining_burst_time);
+            EXPECT_EQ(copy.arrival[i], pcb->arrival);
+        }
+        pcb_soa_destroy(&copy);
+        dyn_array_destroy(queue);
+    }
+    pcb_soa_destroy(&soa);
+}
+
+TEST(CompletionKernel, SimdMatchesScalar)
+{
+    using namespace scheduler_engine;
+    // arrivals sometimes race ahead of the CPU so both the busy and the idle branches are taken
+    uint32_t burst_time[67];
+    uint32_t arrival[67];
+    uint32_t seed = 520;
+    uint32_t arrived = 0;
+    for (size_t i = 0; i < 67; ++i)
+    {
+        seed = seed * 1103515245u + 12345u;
+        burst_time[i] = (seed >> 16) % 50;
+        arrived += (seed >> 8) % 64;
+        arrival[i] = arrived;
+    }
+
+    completion_kernel_t kernels[] = {completion_kernel(), completion_kernel_sse4, completion_kernel_avx2};
+    bool supported[] = {true, __builtin_cpu_supports("sse4.2") != 0, __builtin_cpu_supports("avx2") != 0};
+    for (size_t k = 0; k < 3; ++k)
+    {
+        if (!kernels[k] || !supported[k])
+        {
+            continue;
+        }
+        for (int idle_jumps = 0; idle_jumps < 2; ++idle_jumps)
+        {
+            // every length covers a different tail after the last full block
+            for (size_t n = 0; n <= 67; n += 7)
+            {
+                CompletionState expected = {3, 0, 0, 3, 0};
+                CompletionState actual = expected;
+                completion_kernel_scalar(burst_time, arrival, n, 1, idle_jumps, &expected);
+                kernels[k](burst_time, arrival, n, 1, idle_jumps, &actual);
+                EXPECT_EQ(actual.current_time, expected.current_time);
+                EXPECT_EQ(actual.total_wait_time, expected.total_wait_time);
+                EXPECT_EQ(actual.total_burst_time, expected.total_burst_time);
+                EXPECT_EQ(actual.last_completion, expected.last_completion);
+                EXPECT_EQ(actual.count, expected.count);
+            }
+        }
+    }
+}
+
+TEST(CompletionKernel, ParallelPassMatchesSerial)
+{
+    using namespace scheduler_engine;
+    // long idle gaps every so often so block summaries have to carry both cases
+    const size_t n = 100003;
+    std::vector<uint32_t> burst_time(n);
+    std::vector<uint32_t> arrival(n);
+    uint32_t seed = 520;
+    uint32_t arrived = 0;
+    for (size_t i = 0; i < n; ++i)
+    {
+        seed = seed * 1103515245u + 12345u;
+        burst_time[i] = (seed >> 16) % 100;
+        arrived += (seed >> 8) % 97 == 0 ? 5000 : (seed >> 8) % 50;
+        arrival[i] = arrived;
+    }
+
+    for (int idle_jumps = 0; idle_jumps < 2; ++idle_jumps)
+    {
+        for (size_t threads = 2; threads <= 7; threads += 5)
+        {
+            CompletionState expected = {10, 1, 2, 10, 3};
+            CompletionState actual = expected;
+            completion_pass_serial(&burst_time[0], &arrival[0], n, 1, idle_jumps, &expected);
+            completion_pass_parallel(&burst_time[0], &arrival[0], n, 1, idle_jumps, &actual, threads);
+            EXPECT_EQ(actual.current_time, expected.current_time);
+            EXPECT_EQ(actual.total_wait_time, expected.total_wait_time);
+            EXPECT_EQ(actual.total_burst_time, expected.total_burst_time);
+            EXPECT_EQ(actual.last_completion, expected.last_completion);
+            EXPECT_EQ(actual.count, expected.count);
+        }
+    }
+}
+
+TEST(MapProcessControlBlocks, ReadOnlyViewOfActualFile)
+{
+    PcbFileMap_t map;
+    ASSERT_TRUE(map_process_control_blocks("../pcb.bin", &map));
+    ASSERT_EQ(dyn_array_size(map.records), (size_t)4);
+
+    // records come straight from the file
+    ProcessControlRecord_t *record = (ProcessControlRecord_t *)dyn_array_at(map.records, 0);
+    ASSERT_NE(record, nullptr);
+    EXPECT_EQ((int)record->burst_time, 15);
+    EXPECT_EQ((int)record->arrival, 0);
+
+    // the view refuses to change
+    ProcessControlRecord_t extra = {1, 1, 1};
+    EXPECT_FALSE(dyn_array_push_back(map.records, &extra));
+    EXPECT_FALSE(dyn_array_pop_front(map.records));
+    EXPECT_FALSE(dyn_array_for_each(map.records, [](void *const, void *) {}, nullptr));
+
+    // scheduling needs a copy as ProcessControlBlock_t
+    dyn_array_t *pcbs = process_control_blocks_from_records(map.records);
+    ASSERT_NE(pcbs, nullptr);
+    EXPECT_EQ(dyn_array_size(pcbs), (size_t)4);
+    EXPECT_EQ((int)((ProcessControlBlock_t *)dyn_array_at(pcbs, 3))->remaining_burst_time, 20);
+
+    dyn_array_destroy(pcbs);
+    unmap_process_control_blocks(&map);
+}
+
 // Test cases for first_come_first_serve
 // check null queue
 TEST(FirstComeFirstServe, NullReadyQueue)
@@ -262,6 +952,46 @@ TEST(FirstComeFirstServe, ProcessesOutOfOrderArrival)
     dyn_array_destroy(ready_queue);
 }
 
+TEST(FirstComeFirstServe, StreamMatchesLoadedFile)
+{
+    PcbStream_t *stream = (PcbStream_t *)malloc(sizeof(PcbStream_t));
+    ASSERT_NE(stream, nullptr);
+    ASSERT_TRUE(open_process_control_stream("../pcb.bin", stream));
+    ScheduleResult_t streamed = {0.0f, 0.0f, 0UL};
+    ASSERT_TRUE(first_come_first_serve_stream(stream, &streamed));
+    close_process_control_stream(stream);
+    free(stream);
+
+    dyn_array_t *queue = load_process_control_blocks("../pcb.bin");
+    ASSERT_NE(queue, nullptr);
+    ScheduleResult_t loaded = {0.0f, 0.0f, 0UL};
+    ASSERT_TRUE(first_come_first_serve(queue, &loaded));
+    dyn_array_destroy(queue);
+
+    EXPECT_FLOAT_EQ(streamed.average_waiting_time, loaded.average_waiting_time);
+    EXPECT_FLOAT_EQ(streamed.average_turnaround_time, loaded.average_turnaround_time);
+    EXPECT_EQ(streamed.total_run_time, loaded.total_run_time);
+}
+
+TEST(FirstComeFirstServe, StreamRejectsOutOfOrderArrival)
+{
+    const char *filename = "unordered_stream.bin";
+    FILE *file = fopen(filename, "wb");
+    ASSERT_NE(file, nullptr);
+    uint32_t records[] = {2, 5, 0, 3, 1, 0, 0}; // second pcb arrives before the first
+    fwrite(records, sizeof(uint32_t), 7, file);
+    fclose(file);
+
+    PcbStream_t *stream = (PcbStream_t *)malloc(sizeof(PcbStream_t));
+    ASSERT_NE(stream, nullptr);
+    ASSERT_TRUE(open_process_control_stream(filename, stream));
+    ScheduleResult_t result = {0.0f, 0.0f, 0UL};
+    EXPECT_FALSE(first_come_first_serve_stream(stream, &result));
+    close_process_control_stream(stream);
+    free(stream);
+    remove(filename);
+}
+
 TEST(FirstComeFirstServer, WithGivenPCBFile)
 {
     dyn_array_t *queue = load_process_control_blocks("../pcb.bin");
@@ -626,6 +1356,43 @@ TEST(RoundRobinTest, MultipleProcessesDiffArrivalTimes)
     dyn_array_destroy(queue);
 }
 
+TEST(RoundRobinTest, IdleGapDoesNotDelayReadyProcess)
+{
+    dyn_array_t *queue = dyn_array_create(2, sizeof(ProcessControlBlock_t), NULL);
+
+    ProcessControlBlock_t p1 = {5, 0, 0, false};   // Process 1: Burst 5
+    ProcessControlBlock_t p2 = {1, 0, 100, false}; // Process 2: arrives long after process 1 is done
+
+    dyn_array_push_back(queue, &p1);
+    dyn_array_push_back(queue, &p2);
+
+    ScheduleResult_t result;
+    ASSERT_TRUE(round_robin(queue, &result, 2)); // Quantum = 2
+    ASSERT_EQ(result.average_waiting_time, (float)0);
+    ASSERT_EQ(result.average_turnaround_time, (float)3);
+    ASSERT_EQ(result.total_run_time, 6UL);
+
+    dyn_array_destroy(queue);
+}
+
+TEST(RoundRobinTest, LongBurstsSkipWholeRounds)
+{
+    dyn_array_t *queue = dyn_array_create(2, sizeof(ProcessControlBlock_t), NULL);
+
+    ProcessControlBlock_t p1 = {1000000000, 0, 0, false};
+    ProcessControlBlock_t p2 = {1000000000, 0, 0, false};
+
+    dyn_array_push_back(queue, &p1);
+    dyn_array_push_back(queue, &p2);
+
+    ScheduleResult_t result;
+    ASSERT_TRUE(round_robin(queue, &result, 1)); // Quantum = 1
+    // process 1 finishes at 2e9 - 1 and process 2 at 2e9
+    ASSERT_EQ(result.total_run_time, 3999999999UL);
+
+    dyn_array_destroy(queue);
+}
+
 TEST(RoundRobinTest, WithGivenPCBFile)
 {
     dyn_array_t *queue = load_process_control_blocks("../pcb.bin");
@@ -806,6 +1573,795 @@ TEST(ShortestRemainingTimeFirst, MultipleProcesses)
     dyn_array_destroy(ready_queue);
 }
 
+TEST(ShortestRemainingTimeFirst, PreemptsOnShorterArrival)
+{
+    // long job is preempted by each shorter arrival
+    ProcessControlBlock_t pcb1 = {15, 0, 0, false};
+    ProcessControlBlock_t pcb2 = {10, 0, 1, false};
+    ProcessControlBlock_t pcb3 = {5, 0, 2, false};
+    ProcessControlBlock_t pcb4 = {20, 0, 3, false};
+    dyn_array_t *ready_queue = dyn_array_create(4, sizeof(ProcessControlBlock_t), nullptr);
+    ASSERT_NE(ready_queue, nullptr);
+    dyn_array_push_back(ready_queue, &pcb4);
+    dyn_array_push_back(ready_queue, &pcb3);
+    dyn_array_push_back(ready_queue, &pcb2);
+    dyn_array_push_back(ready_queue, &pcb1);
+    ScheduleResult_t result = {0.0f, 0.0f, 0UL};
+    bool success = shortest_remaining_time_first(ready_queue, &result);
+    // completions: pcb3 at 7, pcb2 at 16, pcb1 at 30, pcb4 at 50
+    EXPECT_EQ(success, true);
+    EXPECT_FLOAT_EQ(result.average_turnaround_time, 24.25f); // (30 + 15 + 5 + 47) / 4
+    EXPECT_FLOAT_EQ(result.average_waiting_time, 11.75f);    // (15 + 5 + 0 + 27) / 4
+    EXPECT_EQ((int)result.total_run_time, 50);
+    // clean up
+    dyn_array_destroy(ready_queue);
+}
+
+TEST(ArrivalAware, ShortestJobWaitsForArrivals)
+{
+    // only the long job is there at 0, the short ones can't jump ahead of it
+    ProcessControlBlock_t pcbs[] = {{2, 0, 2, false}, {10, 0, 0, false}, {1, 0, 1, false}};
+    dyn_array_t *ready_queue = dyn_array_import(pcbs, 3, sizeof(ProcessControlBlock_t), nullptr);
+    ASSERT_NE(ready_queue, nullptr);
+    ScheduleResult_t result = {0.0f, 0.0f, 0UL};
+    ASSERT_TRUE(shortest_job_first_arrival_aware(ready_queue, &result));
+    // 10 runs 0-10, 1 runs 10-11, 2 runs 11-13
+    EXPECT_FLOAT_EQ(result.average_waiting_time, 6.0f);              // (0 + 9 + 9) / 3
+    EXPECT_FLOAT_EQ(result.average_turnaround_time, 31.0f / 3.0f);   // (10 + 10 + 11) / 3
+    EXPECT_EQ(result.total_run_time, 13UL);
+    dyn_array_destroy(ready_queue);
+    EXPECT_FALSE(shortest_job_first_arrival_aware(nullptr, &result));
+}
+
+TEST(ArrivalAware, PriorityIdlesUntilArrival)
+{
+    ProcessControlBlock_t pcbs[] = {{4, 0, 20, false}, {5, 3, 0, false}, {2, 2, 2, false}, {3, 1, 2, false}};
+    dyn_array_t *ready_queue = dyn_array_import(pcbs, 4, sizeof(ProcessControlBlock_t), nullptr);
+    ASSERT_NE(ready_queue, nullptr);
+    ScheduleResult_t result = {0.0f, 0.0f, 0UL};
+    ASSERT_TRUE(priority_arrival_aware(ready_queue, &result));
+    // 0-5 the only arrival, then priority 1 at 5-8 and 2 at 8-10, idle until 20, 20-24
+    EXPECT_FLOAT_EQ(result.average_waiting_time, 2.25f);      // (0 + 3 + 6 + 0) / 4
+    EXPECT_FLOAT_EQ(result.average_turnaround_time, 5.75f);   // (5 + 6 + 8 + 4) / 4
+    EXPECT_EQ(result.total_run_time, 24UL);
+    dyn_array_destroy(ready_queue);
+
+    ready_queue = dyn_array_create(0, sizeof(ProcessControlBlock_t), nullptr);
+    ASSERT_NE(ready_queue, nullptr);
+    ASSERT_TRUE(priority_arrival_aware(ready_queue, &result));
+    EXPECT_EQ(result.total_run_time, 0UL);
+    dyn_array_destroy(ready_queue);
+}
+
+TEST(ArrivalAware, MatchesScanningEveryDispatch)
+{
+    const std::vector<ProcessControlBlock_t> pcbs = random_pcbs(520, 2000, 1, 50, 0, 8, 40000);
+    for (int by_priority = 0; by_priority < 2; ++by_priority)
+    {
+        // the obvious O(n^2) version: at every dispatch scan for the best arrived process
+        std::vector<bool> done(pcbs.size(), false);
+        unsigned long current_time = 0, total_wait = 0, total_turnaround = 0;
+        for (size_t dispatched = 0; dispatched < pcbs.size(); ++dispatched)
+        {
+            size_t best = pcbs.size();
+            unsigned long next_arrival = ULONG_MAX;
+            for (size_t i = 0; i < pcbs.size(); ++i)
+            {
+                if (done[i])
+                {
+                    continue;
+                }
+                if (pcbs[i].arrival > current_time)
+                {
+                    next_arrival = pcbs[i].arrival < next_arrival ? pcbs[i].arrival : next_arrival;
+                    continue;
+                }
+                uint32_t key = by_priority ? pcbs[i].priority : pcbs[i].remaining_burst_time;
+                uint32_t best_key = best < pcbs.size() ? (by_priority ? pcbs[best].priority : pcbs[best].remaining_burst_time) : 0;
+                if (best == pcbs.size() || key < best_key || (key == best_key && pcbs[i].arrival < pcbs[best].arrival))
+                {
+                    best = i;
+                }
+            }
+            if (best == pcbs.size())
+            {
+                current_time = next_arrival;
+                --dispatched;
+                continue;
+            }
+            done[best] = true;
+            total_wait += current_time - pcbs[best].arrival;
+            current_time += pcbs[best].remaining_burst_time;
+            total_turnaround += current_time - pcbs[best].arrival;
+        }
+
+        dyn_array_t *ready_queue = dyn_array_import(&pcbs[0], pcbs.size(), sizeof(ProcessControlBlock_t), nullptr);
+        ASSERT_NE(ready_queue, nullptr);
+        ScheduleResult_t result = {0.0f, 0.0f, 0UL};
+        ASSERT_TRUE(by_priority ? priority_arrival_aware(ready_queue, &result)
+                                : shortest_job_first_arrival_aware(ready_queue, &result));
+        EXPECT_FLOAT_EQ(result.average_waiting_time, (float)total_wait / pcbs.size());
+        EXPECT_FLOAT_EQ(result.average_turnaround_time, (float)total_turnaround / pcbs.size());
+        EXPECT_EQ(result.total_run_time, current_time);
+        dyn_array_destroy(ready_queue);
+    }
+}
+
+TEST(PreemptivePriority, AgingPreemptsTheRunningProcess)
+{
+    // a low priority job at 0 behind a stream of priority 1 jobs
+    ProcessControlBlock_t pcbs[] = {{2, 3, 0, false}, {10, 1, 0, false}, {10, 1, 10, false}, {10, 1, 20, false}};
+    ScheduleResult_t result = {0.0f, 0.0f, 0UL};
+
+    // without aging it waits for all of them
+    dyn_array_t *ready_queue = dyn_array_import(pcbs, 4, sizeof(ProcessControlBlock_t), nullptr);
+    ASSERT_NE(ready_queue, nullptr);
+    ASSERT_TRUE(preemptive_priority(ready_queue, &result, 0));
+    EXPECT_FLOAT_EQ(result.average_waiting_time, 7.5f);      // (30 + 0 + 0 + 0) / 4
+    EXPECT_FLOAT_EQ(result.average_turnaround_time, 15.5f);  // (32 + 10 + 10 + 10) / 4
+    EXPECT_EQ(result.total_run_time, 32UL);
+    dyn_array_destroy(ready_queue);
+
+    // every 3 waited is a level, at 9 it's at 0 and takes the CPU from the first priority 1 job
+    // 9-11 the low job, 11-12 the rest of the first, 12-22 and 22-32 the others
+    ready_queue = dyn_array_import(pcbs, 4, sizeof(ProcessControlBlock_t), nullptr);
+    ASSERT_NE(ready_queue, nullptr);
+    ASSERT_TRUE(preemptive_priority(ready_queue, &result, 3));
+    EXPECT_FLOAT_EQ(result.average_waiting_time, 3.75f);      // (9 + 2 + 2 + 2) / 4
+    EXPECT_FLOAT_EQ(result.average_turnaround_time, 11.75f);  // (11 + 12 + 12 + 12) / 4
+    EXPECT_EQ(result.total_run_time, 32UL);
+    dyn_array_destroy(ready_queue);
+
+    EXPECT_FALSE(preemptive_priority(nullptr, &result, 3));
+}
+
+TEST(PreemptivePriority, MatchesTickByTick)
+{
+    const std::vector<ProcessControlBlock_t> pcbs = random_pcbs(520, 300, 1, 20, 0, 10, 3000);
+    const std::vector<ProcessControlBlock_t> by_arrival = sorted_by_arrival(pcbs);
+    const size_t n = by_arrival.size();
+
+    const size_t intervals[] = {0, 1, 3, 7};
+    for (size_t interval : intervals)
+    {
+        // one tick at a time, every waiting process ages every tick
+        std::vector<uint32_t> remaining(n);
+        std::vector<unsigned long> waited(n, 0);
+        std::vector<bool> waiting(n, false);
+        for (size_t i = 0; i < n; ++i)
+        {
+            remaining[i] = by_arrival[i].remaining_burst_time;
+        }
+        // best waiting process: effective priority, then priority * interval - waited, then arrival order
+        auto best_waiting = [&]() {
+            size_t best = n;
+            for (size_t i = 0; i < n; ++i)
+            {
+                if (!waiting[i])
+                {
+                    continue;
+                }
+                if (best == n)
+                {
+                    best = i;
+                    continue;
+                }
+                long long key = interval ? (long long)(by_arrival[i].priority * interval) - (long long)waited[i]
+                                         : by_arrival[i].priority;
+                long long best_key = interval ? (long long)(by_arrival[best].priority * interval) - (long long)waited[best]
+                                              : by_arrival[best].priority;
+                if (key < best_key)
+                {
+                    best = i;
+                }
+            }
+            return best;
+        };
+        unsigned long t = 0, total_wait = 0, total_turnaround = 0, running_priority = 0;
+        size_t next = 0, done = 0, running = n;
+        while (done < n)
+        {
+            for (; next < n && by_arrival[next].arrival <= t; ++next)
+            {
+                waiting[next] = true;
+            }
+            if (running < n && remaining[running] == 0)
+            {
+                total_turnaround += t - by_arrival[running].arrival;
+                total_wait += t - by_arrival[running].arrival - by_arrival[running].remaining_burst_time;
+                running = n;
+                ++done;
+                continue;
+            }
+            size_t best = best_waiting();
+            if (running == n && best == n)
+            {
+                t = by_arrival[next].arrival;
+                continue;
+            }
+            if (best < n && (running == n || scheduler_engine::aged_priority(by_arrival[best].priority, waited[best],
+                                                                             interval) < running_priority))
+            {
+                if (running < n)
+                {
+                    waiting[running] = true;
+                }
+                waiting[best] = false;
+                running = best;
+                running_priority = scheduler_engine::aged_priority(by_arrival[best].priority, waited[best], interval);
+            }
+            --remaining[running];
+            for (size_t i = 0; i < n; ++i)
+            {
+                waited[i] += waiting[i];
+            }
+            ++t;
+        }
+
+        dyn_array_t *ready_queue = dyn_array_import(&pcbs[0], n, sizeof(ProcessControlBlock_t), nullptr);
+        ASSERT_NE(ready_queue, nullptr);
+        ScheduleResult_t result = {0.0f, 0.0f, 0UL};
+        ASSERT_TRUE(preemptive_priority(ready_queue, &result, interval));
+        EXPECT_FLOAT_EQ(result.average_waiting_time, (float)total_wait / n) << "interval " << interval;
+        EXPECT_FLOAT_EQ(result.average_turnaround_time, (float)total_turnaround / n) << "interval " << interval;
+        EXPECT_EQ(result.total_run_time, t) << "interval " << interval;
+        dyn_array_destroy(ready_queue);
+    }
+}
+
+TEST(MultiLevelFeedbackQueue, DemotesAndPreemptsBelowTheTop)
+{
+    // 0-1 A alone, B arrives and A finishes its level 0 quantum 1-2, B 2-3, A on level 1 3-4,
+    // C preempts it at 4 and uses up its level 0 quantum 4-6, A resumes first 6-8, C 8-9
+    ProcessControlBlock_t pcbs[] = {{5, 0, 0, false}, {1, 0, 1, false}, {3, 0, 4, false}};
+    const size_t quanta[] = {2, 4};
+    MlfqConfig_t config = {2, quanta, 0};
+    ScheduleResult_t result = {0.0f, 0.0f, 0UL};
+
+    dyn_array_t *ready_queue = dyn_array_import(pcbs, 3, sizeof(ProcessControlBlock_t), nullptr);
+    ASSERT_NE(ready_queue, nullptr);
+    ASSERT_TRUE(multi_level_feedback_queue(ready_queue, &result, &config));
+    EXPECT_FLOAT_EQ(result.average_waiting_time, 2.0f);       // (3 + 1 + 2) / 3
+    EXPECT_FLOAT_EQ(result.average_turnaround_time, 5.0f);    // (8 + 2 + 5) / 3
+    EXPECT_EQ(result.total_run_time, 9UL);
+
+    const size_t zero_quanta[] = {2, 0};
+    MlfqConfig_t bad = {2, zero_quanta, 0};
+    EXPECT_FALSE(multi_level_feedback_queue(ready_queue, &result, &bad));
+    bad.quanta = quanta;
+    bad.levels = MLFQ_MAX_LEVELS + 1;
+    EXPECT_FALSE(multi_level_feedback_queue(ready_queue, &result, &bad));
+    EXPECT_FALSE(multi_level_feedback_queue(ready_queue, &result, nullptr));
+    EXPECT_FALSE(multi_level_feedback_queue(nullptr, &result, &config));
+    dyn_array_destroy(ready_queue);
+}
+
+TEST(MultiLevelFeedbackQueue, OneLevelIsRoundRobin)
+{
+    const size_t quantum = 4;
+    MlfqConfig_t config = {1, &quantum, 0};
+    ScheduleResult_t expected = {0.0f, 0.0f, 0UL};
+    ScheduleResult_t result = {0.0f, 0.0f, 0UL};
+
+    dyn_array_t *ready_queue = load_process_control_blocks("../pcb.bin");
+    ASSERT_NE(ready_queue, nullptr);
+    ASSERT_TRUE(round_robin(ready_queue, &expected, quantum));
+    dyn_array_destroy(ready_queue);
+
+    ready_queue = load_process_control_blocks("../pcb.bin");
+    ASSERT_NE(ready_queue, nullptr);
+    ASSERT_TRUE(multi_level_feedback_queue(ready_queue, &result, &config));
+    EXPECT_FLOAT_EQ(result.average_waiting_time, expected.average_waiting_time);
+    EXPECT_FLOAT_EQ(result.average_turnaround_time, expected.average_turnaround_time);
+    dyn_array_destroy(ready_queue);
+}
+
+TEST(MultiLevelFeedbackQueue, MatchesTickByTick)
+{
+    const std::vector<ProcessControlBlock_t> pcbs = random_pcbs(523, 300, 1, 40, 0, 1, 4000);
+    const std::vector<ProcessControlBlock_t> by_arrival = sorted_by_arrival(pcbs);
+    const size_t n = by_arrival.size();
+
+    const size_t quanta[] = {1, 3, 8, 20};
+    const size_t boosts[] = {0, 25, 100};
+    for (size_t levels = 1; levels <= 4; ++levels)
+    {
+        for (size_t boost : boosts)
+        {
+            // one tick at a time with a deque per level
+            std::vector<std::vector<size_t> > queues(levels);
+            std::vector<uint32_t> remaining(n);
+            std::vector<size_t> used(n, 0), level(n, 0);
+            for (size_t i = 0; i < n; ++i)
+            {
+                remaining[i] = by_arrival[i].remaining_burst_time;
+            }
+            auto best_level = [&]() {
+                size_t l = 0;
+                while (l < levels && queues[l].empty())
+                {
+                    ++l;
+                }
+                return l;
+            };
+            unsigned long t = 0, total_wait = 0, total_turnaround = 0;
+            size_t next = 0, done = 0, running = n;
+            while (done < n)
+            {
+                for (; next < n && by_arrival[next].arrival <= t; ++next)
+                {
+                    queues[0].push_back(next);
+                }
+                if (running < n)
+                {
+                    if (remaining[running] == 0)
+                    {
+                        total_turnaround += t - by_arrival[running].arrival;
+                        total_wait += t - by_arrival[running].arrival - by_arrival[running].remaining_burst_time;
+                        ++done;
+                        running = n;
+                    }
+                    else if (used[running] == quanta[level[running]])
+                    {
+                        used[running] = 0;
+                        level[running] += level[running] + 1 < levels;
+                        queues[level[running]].push_back(running);
+                        running = n;
+                    }
+                    else if (best_level() < level[running])
+                    {
+                        queues[level[running]].insert(queues[level[running]].begin(), running);
+                        running = n;
+                    }
+                }
+                if (done == n)
+                {
+                    break;
+                }
+                if (boost && t && t % boost == 0)
+                {
+                    if (running < n)
+                    {
+                        queues[level[running]].insert(queues[level[running]].begin(), running);
+                        running = n;
+                    }
+                    for (size_t l = 1; l < levels; ++l)
+                    {
+                        queues[0].insert(queues[0].end(), queues[l].begin(), queues[l].end());
+                        queues[l].clear();
+                    }
+                    for (size_t i : queues[0])
+                    {
+                        used[i] = 0;
+                        level[i] = 0;
+                    }
+                }
+                if (running == n)
+                {
+                    size_t l = best_level();
+                    if (l == levels)
+                    {
+                        ++t;
+                        continue;
+                    }
+                    running = queues[l].front();
+                    queues[l].erase(queues[l].begin());
+                }
+                --remaining[running];
+                ++used[running];
+                ++t;
+            }
+
+            MlfqConfig_t config = {levels, quanta, boost};
+            dyn_array_t *ready_queue = dyn_array_import(&pcbs[0], n, sizeof(ProcessControlBlock_t), nullptr);
+            ASSERT_NE(ready_queue, nullptr);
+            ScheduleResult_t result = {0.0f, 0.0f, 0UL};
+            ASSERT_TRUE(multi_level_feedback_queue(ready_queue, &result, &config));
+            EXPECT_FLOAT_EQ(result.average_waiting_time, (float)total_wait / n) << levels << " levels, boost " << boost;
+            EXPECT_FLOAT_EQ(result.average_turnaround_time, (float)total_turnaround / n)
+                << levels << " levels, boost " << boost;
+            EXPECT_EQ(result.total_run_time, t) << levels << " levels, boost " << boost;
+            dyn_array_destroy(ready_queue);
+        }
+    }
+}
+
+TEST(MultiCore, IdleCoreStealsFromBusyOne)
+{
+    // core 0 runs 0 0-10 with 2 queued behind it, core 1 runs 1 0-2 then 3 2-6, then steals 2 6-9
+    ProcessControlBlock_t pcbs[] = {{10, 0, 0, false}, {2, 0, 0, false}, {3, 0, 1, false}, {4, 0, 1, false}};
+    const StealPolicy_t steals[] = {STEAL_RANDOM_VICTIM, STEAL_MOST_LOADED};
+    for (StealPolicy_t steal : steals)
+    {
+        MultiCoreConfig_t config = {2, steal, 520};
+        ScheduleResult_t result = {0.0f, 0.0f, 0UL};
+        float utilization[2] = {0.0f, 0.0f};
+        dyn_array_t *ready_queue = dyn_array_import(pcbs, 4, sizeof(ProcessControlBlock_t), nullptr);
+        ASSERT_NE(ready_queue, nullptr);
+        ASSERT_TRUE(multi_core_first_come_first_serve(ready_queue, &result, &config, utilization));
+        EXPECT_FLOAT_EQ(result.average_waiting_time, 1.5f);       // (0 + 0 + 5 + 1) / 4
+        EXPECT_FLOAT_EQ(result.average_turnaround_time, 6.25f);   // (10 + 2 + 8 + 5) / 4
+        EXPECT_EQ(result.total_run_time, 10UL);
+        EXPECT_FLOAT_EQ(utilization[0], 1.0f);
+        EXPECT_FLOAT_EQ(utilization[1], 0.9f);
+        dyn_array_destroy(ready_queue);
+    }
+
+    MultiCoreConfig_t config = {0, STEAL_MOST_LOADED, 0};
+    ScheduleResult_t result = {0.0f, 0.0f, 0UL};
+    dyn_array_t *ready_queue = dyn_array_import(pcbs, 4, sizeof(ProcessControlBlock_t), nullptr);
+    ASSERT_NE(ready_queue, nullptr);
+    EXPECT_FALSE(multi_core_first_come_first_serve(ready_queue, &result, &config, nullptr));
+    EXPECT_FALSE(multi_core_first_come_first_serve(ready_queue, &result, nullptr, nullptr));
+    dyn_array_destroy(ready_queue);
+}
+
+TEST(MultiCore, OneCoreIsFirstComeFirstServe)
+{
+    MultiCoreConfig_t config = {1, STEAL_RANDOM_VICTIM, 0};
+    ScheduleResult_t expected = {0.0f, 0.0f, 0UL};
+    ScheduleResult_t result = {0.0f, 0.0f, 0UL};
+
+    // arrival order FCFS that idles until the next arrival
+    dyn_array_t *ready_queue = load_process_control_blocks("../pcb.bin");
+    ASSERT_NE(ready_queue, nullptr);
+    for (size_t i = 0; i < dyn_array_size(ready_queue); ++i)
+    {
+        static_cast<ProcessControlBlock_t *>(dyn_array_at(ready_queue, i))->priority = 0;
+    }
+    ASSERT_TRUE(priority_arrival_aware(ready_queue, &expected));
+    dyn_array_destroy(ready_queue);
+
+    float utilization = 0.0f;
+    ready_queue = load_process_control_blocks("../pcb.bin");
+    ASSERT_NE(ready_queue, nullptr);
+    ASSERT_TRUE(multi_core_first_come_first_serve(ready_queue, &result, &config, &utilization));
+    EXPECT_FLOAT_EQ(result.average_waiting_time, expected.average_waiting_time);
+    EXPECT_FLOAT_EQ(result.average_turnaround_time, expected.average_turnaround_time);
+    EXPECT_EQ(result.total_run_time, expected.total_run_time);
+    EXPECT_GT(utilization, 0.0f);
+    EXPECT_LE(utilization, 1.0f);
+    dyn_array_destroy(ready_queue);
+}
+
+TEST(MultiCore, MatchesScanningEveryCore)
+{
+    const std::vector<ProcessControlBlock_t> pcbs = random_pcbs(524, 500, 0, 60, 0, 1, 3000);
+    const std::vector<ProcessControlBlock_t> by_arrival = sorted_by_arrival(pcbs);
+    const size_t n = by_arrival.size();
+    unsigned long total_burst = 0;
+    for (const ProcessControlBlock_t &pcb : by_arrival)
+    {
+        total_burst += pcb.remaining_burst_time;
+    }
+
+    const size_t core_counts[] = {1, 2, 3, 8, 40};
+    for (size_t cores : core_counts)
+    {
+        // most loaded stealing with every decision a scan over the cores
+        std::vector<std::vector<size_t> > fifos(cores);
+        std::vector<unsigned long> work(cores, 0), free_at(cores, 0), busy(cores, 0);
+        std::vector<bool> running(cores, false);
+        unsigned long total_wait = 0, total_turnaround = 0, makespan = 0;
+        auto start = [&](size_t core, unsigned long t) {
+            size_t from = core;
+            if (fifos[core].empty())
+            {
+                for (size_t c = 0; c < cores; ++c)
+                {
+                    if (!fifos[c].empty() && (fifos[from].empty() || work[c] >= work[from]))
+                    {
+                        from = c;
+                    }
+                }
+                if (fifos[from].empty())
+                {
+                    running[core] = false;
+                    return;
+                }
+            }
+            size_t index;
+            if (from == core)
+            {
+                index = fifos[core].front();
+                fifos[core].erase(fifos[core].begin());
+            }
+            else
+            {
+                index = fifos[from].back();
+                fifos[from].pop_back();
+            }
+            const uint32_t burst = by_arrival[index].remaining_burst_time;
+            work[from] -= burst;
+            running[core] = true;
+            free_at[core] = t + burst;
+            busy[core] += burst;
+            total_wait += t - by_arrival[index].arrival;
+            total_turnaround += t + burst - by_arrival[index].arrival;
+            makespan = std::max(makespan, t + burst);
+        };
+        size_t next = 0;
+        for (;;)
+        {
+            size_t first_free = cores;
+            for (size_t c = 0; c < cores; ++c)
+            {
+                if (running[c] && (first_free == cores || free_at[c] < free_at[first_free]))
+                {
+                    first_free = c;
+                }
+            }
+            if (first_free < cores && (next == n || free_at[first_free] <= by_arrival[next].arrival))
+            {
+                start(first_free, free_at[first_free]);
+            }
+            else if (next < n)
+            {
+                const size_t home = next % cores;
+                fifos[home].push_back(next);
+                work[home] += by_arrival[next].remaining_burst_time;
+                size_t core = running[home] ? cores : home;
+                for (size_t c = 0; c < cores && core == cores; ++c)
+                {
+                    core = running[c] ? cores : c;
+                }
+                const unsigned long t = by_arrival[next++].arrival;
+                if (core < cores)
+                {
+                    start(core, t);
+                }
+            }
+            else
+            {
+                break;
+            }
+        }
+
+        MultiCoreConfig_t config = {cores, STEAL_MOST_LOADED, 0};
+        std::vector<float> utilization(cores);
+        dyn_array_t *ready_queue = dyn_array_import(&pcbs[0], n, sizeof(ProcessControlBlock_t), nullptr);
+        ASSERT_NE(ready_queue, nullptr);
+        ScheduleResult_t result = {0.0f, 0.0f, 0UL};
+        ASSERT_TRUE(multi_core_first_come_first_serve(ready_queue, &result, &config, &utilization[0]));
+        EXPECT_FLOAT_EQ(result.average_waiting_time, (float)total_wait / n) << cores << " cores";
+        EXPECT_FLOAT_EQ(result.average_turnaround_time, (float)total_turnaround / n) << cores << " cores";
+        EXPECT_EQ(result.total_run_time, makespan) << cores << " cores";
+        for (size_t c = 0; c < cores; ++c)
+        {
+            EXPECT_FLOAT_EQ(utilization[c], (float)busy[c] / makespan) << cores << " cores, core " << c;
+        }
+        dyn_array_destroy(ready_queue);
+
+        // random victims do the same work, every process runs once
+        config.steal = STEAL_RANDOM_VICTIM;
+        ready_queue = dyn_array_import(&pcbs[0], n, sizeof(ProcessControlBlock_t), nullptr);
+        ASSERT_NE(ready_queue, nullptr);
+        ASSERT_TRUE(multi_core_first_come_first_serve(ready_queue, &result, &config, &utilization[0]));
+        float busy_total = 0.0f;
+        for (size_t c = 0; c < cores; ++c)
+        {
+            busy_total += utilization[c] * result.total_run_time;
+        }
+        EXPECT_NEAR(busy_total, (float)total_burst, total_burst * 1e-4f) << cores << " cores";
+        EXPECT_NEAR(result.average_turnaround_time - result.average_waiting_time, (float)total_burst / n, 1e-3f);
+        dyn_array_destroy(ready_queue);
+    }
+}
+
+TEST(CompletelyFair, EqualWeightsTakeTurns)
+{
+    // two runnable, each gets half of the latency of 4: A 0-2, B 2-4, A 4-6, B 6-8, A 8-10, B 10-12
+    ProcessControlBlock_t pcbs[] = {{6, 20, 0, false}, {6, 20, 0, false}};
+    CfsConfig_t config = {4, 1};
+    ScheduleResult_t result = {0.0f, 0.0f, 0UL};
+    dyn_array_t *ready_queue = dyn_array_import(pcbs, 2, sizeof(ProcessControlBlock_t), nullptr);
+    ASSERT_NE(ready_queue, nullptr);
+    ASSERT_TRUE(completely_fair(ready_queue, &result, &config));
+    EXPECT_FLOAT_EQ(result.average_waiting_time, 5.0f);       // (4 + 6) / 2
+    EXPECT_FLOAT_EQ(result.average_turnaround_time, 11.0f);   // (10 + 12) / 2
+    EXPECT_EQ(result.total_run_time, 12UL);
+
+    CfsConfig_t bad = {4, 0};
+    EXPECT_FALSE(completely_fair(ready_queue, &result, &bad));
+    EXPECT_FALSE(completely_fair(ready_queue, &result, nullptr));
+    EXPECT_FALSE(completely_fair(nullptr, &result, &config));
+    dyn_array_destroy(ready_queue);
+}
+
+TEST(CompletelyFair, WeightsShareTheLatency)
+{
+    // nice 0 (1024) against nice -5 (3121) over a latency of 8: slices of 1 and 6
+    // A 0-1, B 1-7, A 7-8, B 8-14 and A alone 14-16
+    ProcessControlBlock_t pcbs[] = {{4, 20, 0, false}, {12, 15, 0, false}};
+    CfsConfig_t config = {8, 1};
+    ScheduleResult_t result = {0.0f, 0.0f, 0UL};
+    dyn_array_t *ready_queue = dyn_array_import(pcbs, 2, sizeof(ProcessControlBlock_t), nullptr);
+    ASSERT_NE(ready_queue, nullptr);
+    ASSERT_TRUE(completely_fair(ready_queue, &result, &config));
+    EXPECT_FLOAT_EQ(result.average_waiting_time, 7.0f);       // (12 + 2) / 2
+    EXPECT_FLOAT_EQ(result.average_turnaround_time, 15.0f);   // (16 + 14) / 2
+    EXPECT_EQ(result.total_run_time, 16UL);
+    dyn_array_destroy(ready_queue);
+}
+
+TEST(CompletelyFair, MatchesScanningEverySlice)
+{
+    const std::vector<ProcessControlBlock_t> pcbs = random_pcbs(525, 200, 0, 50, 10, 25, 5000);
+    const std::vector<ProcessControlBlock_t> by_arrival = sorted_by_arrival(pcbs);
+    const size_t n = by_arrival.size();
+
+    const CfsConfig_t configs[] = {{4, 1}, {6, 2}, {20, 3}, {3, 5}};
+    for (const CfsConfig_t &config : configs)
+    {
+        // one slice per dispatch, the next process found by scanning every runnable one
+        std::vector<uint32_t> remaining(n);
+        std::vector<uint64_t> placed(n, 0);
+        std::vector<bool> runnable(n, false);
+        for (size_t i = 0; i < n; ++i)
+        {
+            remaining[i] = by_arrival[i].remaining_burst_time;
+        }
+        auto vruntime = [&](size_t i, uint64_t extra) {
+            return placed[i] + scheduler_engine::fair_virtual_time(by_arrival[i].remaining_burst_time - remaining[i] + extra,
+                                                                  scheduler_engine::fair_weight(by_arrival[i].priority));
+        };
+        auto leftmost = [&]() {
+            size_t best = n;
+            for (size_t i = 0; i < n; ++i)
+            {
+                if (runnable[i] && (best == n || vruntime(i, 0) < vruntime(best, 0)))
+                {
+                    best = i;
+                }
+            }
+            return best;
+        };
+        uint64_t min_vruntime = 0;
+        auto follow = [&](uint64_t running_vruntime) {
+            size_t best = leftmost();
+            uint64_t smallest = best < n && vruntime(best, 0) < running_vruntime ? vruntime(best, 0) : running_vruntime;
+            min_vruntime = std::max(min_vruntime, smallest);
+        };
+        unsigned long t = 0, total_wait = 0, total_turnaround = 0;
+        size_t next = 0;
+        for (;;)
+        {
+            if (leftmost() == n && next < n && t < by_arrival[next].arrival)
+            {
+                t = by_arrival[next].arrival;
+            }
+            for (; next < n && by_arrival[next].arrival <= t; ++next)
+            {
+                placed[next] = min_vruntime;
+                runnable[next] = true;
+            }
+            const size_t running = leftmost();
+            if (running == n)
+            {
+                break;
+            }
+            runnable[running] = false;
+            uint64_t count = 1, weight = scheduler_engine::fair_weight(by_arrival[running].priority), total_weight = weight;
+            for (size_t i = 0; i < n; ++i)
+            {
+                count += runnable[i];
+                total_weight += runnable[i] ? scheduler_engine::fair_weight(by_arrival[i].priority) : 0;
+            }
+            uint64_t period = count > config.target_latency / config.min_granularity ? count * config.min_granularity
+                                                                                      : config.target_latency;
+            uint64_t slice = std::max<uint64_t>(period * weight / total_weight, config.min_granularity);
+            uint64_t ran = std::min<uint64_t>(slice, remaining[running]);
+            for (; next < n && by_arrival[next].arrival <= t + ran; ++next)
+            {
+                follow(vruntime(running, by_arrival[next].arrival - t));
+                placed[next] = min_vruntime;
+                runnable[next] = true;
+            }
+            remaining[running] -= ran;
+            t += ran;
+            follow(vruntime(running, 0));
+            if (remaining[running] == 0)
+            {
+                total_turnaround += t - by_arrival[running].arrival;
+                total_wait += t - by_arrival[running].arrival - by_arrival[running].remaining_burst_time;
+            }
+            else
+            {
+                runnable[running] = true;
+            }
+        }
+
+        dyn_array_t *ready_queue = dyn_array_import(&pcbs[0], n, sizeof(ProcessControlBlock_t), nullptr);
+        ASSERT_NE(ready_queue, nullptr);
+        ScheduleResult_t result = {0.0f, 0.0f, 0UL};
+        ASSERT_TRUE(completely_fair(ready_queue, &result, &config));
+        EXPECT_FLOAT_EQ(result.average_waiting_time, (float)total_wait / n) << "latency " << config.target_latency;
+        EXPECT_FLOAT_EQ(result.average_turnaround_time, (float)total_turnaround / n) << "latency " << config.target_latency;
+        EXPECT_EQ(result.total_run_time, t) << "latency " << config.target_latency;
+        dyn_array_destroy(ready_queue);
+    }
+}
+
+// Runs pcbgen from the build directory and loads what it wrote
+static dyn_array_t *generate_pcbs(const char *options)
+{
+    char command[256];
+    snprintf(command, sizeof(command), "./pcbgen 200000 pcbgen_test.bin %s", options);
+    if (system(command) != 0)
+    {
+        return nullptr;
+    }
+    dyn_array_t *pcbs = load_process_control_blocks("pcbgen_test.bin");
+    remove("pcbgen_test.bin");
+    return pcbs;
+}
+
+TEST(PcbGen, BurstyArrivalsKeepTheMeanGap)
+{
+    const double batches[] = {1, 4};
+    for (double batch : batches)
+    {
+        char options[128];
+        snprintf(options, sizeof(options), "--burst exp:50 --arrival bursty:10:%g --priority uniform:16 --seed 7", batch);
+        dyn_array_t *pcbs = generate_pcbs(options);
+        ASSERT_NE(pcbs, nullptr) << options;
+        const size_t n = dyn_array_size(pcbs);
+        ASSERT_EQ(n, 200000u);
+
+        double bursts = 0, priorities = 0;
+        size_t groups = 0;
+        for (size_t i = 0; i < n; ++i)
+        {
+            const ProcessControlBlock_t *pcb = static_cast<const ProcessControlBlock_t *>(dyn_array_at(pcbs, i));
+            bursts += pcb->remaining_burst_time;
+            priorities += pcb->priority;
+            groups += i == 0 || pcb->arrival != static_cast<const ProcessControlBlock_t *>(dyn_array_at(pcbs, i - 1))->arrival;
+        }
+        const ProcessControlBlock_t *last = static_cast<const ProcessControlBlock_t *>(dyn_array_back(pcbs));
+
+        // one pcb per mean gap however they are batched
+        EXPECT_NEAR((double)last->arrival / n, 10.0, 0.3) << options;
+        // batches average the requested size, a few short gaps truncate into the same time
+        EXPECT_NEAR((double)n / groups, batch, batch * 0.06) << options;
+        // exp:50 truncated to whole ticks
+        EXPECT_NEAR(bursts / n, 49.5, 0.5) << options;
+        EXPECT_NEAR(priorities / n, 7.5, 0.1) << options;
+        dyn_array_destroy(pcbs);
+    }
+}
+
+TEST(PcbGen, SameSeedSameFile)
+{
+    dyn_array_t *first = generate_pcbs("--arrival bursty:5:3 --seed 11");
+    dyn_array_t *second = generate_pcbs("--arrival bursty:5:3 --seed 11");
+    ASSERT_NE(first, nullptr);
+    ASSERT_NE(second, nullptr);
+    ASSERT_EQ(dyn_array_size(first), dyn_array_size(second));
+    EXPECT_EQ(memcmp(dyn_array_export(first), dyn_array_export(second),
+                     dyn_array_size(first) * sizeof(ProcessControlBlock_t)), 0);
+    dyn_array_destroy(first);
+    dyn_array_destroy(second);
+}
+
+// Runs a quantum sweep over pcb.bin with analysis from the build directory, returns the exit status
+static int run_sweep(const char *quanta)
+{
+    char command[256];
+    snprintf(command, sizeof(command), "./analysis pcb.bin SWEEP '%s' > /dev/null 2>&1", quanta);
+    return system(command);
+}
+
+TEST(QuantumSweep, RejectsZeroAndBackwardsRanges)
+{
+    EXPECT_EQ(run_sweep("1..3,10"), 0);
+    EXPECT_EQ(run_sweep("4"), 0);
+    // any bad entry fails the whole list instead of dropping it
+    EXPECT_NE(run_sweep("0..3,10"), 0);
+    EXPECT_NE(run_sweep("0"), 0);
+    EXPECT_NE(run_sweep("10,5..3"), 0);
+    EXPECT_NE(run_sweep("1..3x"), 0);
+}
+
 class GradeEnvironment : public testing::Environment
 {
 public: